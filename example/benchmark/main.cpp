@@ -0,0 +1,261 @@
+/**
+ *	Application entry point for benchmark.
+ *	This is a tiny application that times the hot paths
+ *	of the C++ version of the PureMVC framework: sending
+ *	notifications to commands and to mediators, retrieving
+ *	proxies from commands, and removing mediators.
+ *
+ *	PureMVC++ - Copyright(c) 2009 Schell Scivally Enterprise, some rights reserved.
+ *	Your reuse is governed by the Creative Commons Attribution 3.0 United States License
+ *
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstdio>
+#include <time.h>
+#include "pmvcpp.h"
+
+using namespace std;
+using namespace PureMVC;
+
+//--------------------------------------
+//  Notification Definitions
+//--------------------------------------
+class n_name
+{
+public:
+    enum name
+    {
+        NIL,
+        POOLED_COMMAND,     // executes a pooled command
+        TRANSIENT_COMMAND,  // executes a transient command
+        MEDIATOR,           // notifies a mediator
+        FAN_OUT,            // notifies FAN_OUT_MEDIATORS mediators
+        RETRIEVE,           // executes a command that retrieves RETRIEVED proxies
+        MANY_COMMANDS       // first of COMMANDS names, each executing a pooled command
+    };
+    static const int COMMANDS = 256;
+    static const int PROXIES = 32;
+    static const int RETRIEVED = 4;
+    static const int FAN_OUT_MEDIATORS = 500;
+};
+//--------------------------------------
+//  Commands
+//--------------------------------------
+/**
+ *	Count - counts its executions.
+ */
+class Count : public SimpleCommand
+{
+public:
+    void execute(INotification* note)
+    {
+        Count::executions++;
+    }
+    static long executions;
+};
+long Count::executions = 0;
+/**
+ *	Retrieve - looks up a few of the registered proxies, by name
+ *	constant and by literal, the way commands usually do.
+ */
+class Retrieve : public SimpleCommand
+{
+public:
+    void execute(INotification* note)
+    {
+        Retrieve::found += this->getFacade()->retrieveProxy(Retrieve::FIRST) != (IProxy*) 0;
+        Retrieve::found += this->getFacade()->retrieveProxy(Retrieve::SECOND) != (IProxy*) 0;
+        Retrieve::found += this->getFacade()->retrieveProxy("proxy17") != (IProxy*) 0;
+        Retrieve::found += this->getFacade()->hasProxy("proxy31");
+    }
+    static const string FIRST;
+    static const string SECOND;
+    static long found;
+};
+const string Retrieve::FIRST = "proxy3";
+const string Retrieve::SECOND = "proxy11";
+long Retrieve::found = 0;
+//--------------------------------------
+//  Proxies
+//--------------------------------------
+class NamedProxy : public Proxy
+{
+public:
+    NamedProxy(string proxyName) : Proxy(proxyName) {}
+    void onRegister() {}
+    void onRemove() {}
+};
+//--------------------------------------
+//  Mediators
+//--------------------------------------
+/**
+ *	CountMediator - counts the notifications it handles.
+ */
+class CountMediator : public Mediator
+{
+public:
+    static const string NAME;
+
+    CountMediator(string mediatorName, int interest = n_name::MEDIATOR) : Mediator(mediatorName)
+    {
+        this->interest = interest;
+        this->handled = 0;
+    }
+    void onRegister() {}
+    void onRemove() {}
+    vector<int> listNotificationInterests()
+    {
+        vector<int> interests;
+        interests.push_back(this->interest);
+        return interests;
+    }
+    void handleNotification(INotification* note)
+    {
+        this->handled++;
+    }
+    int interest;
+    long handled;
+};
+const string CountMediator::NAME = "CountMediator";
+/**
+ *	Tick - a typed payload, and TickCounter, its handler.
+ */
+struct Tick
+{
+    long count;
+};
+class TickCounter
+{
+public:
+    TickCounter() : total(0) {}
+    void onTick(const Tick& tick)
+    {
+        this->total += tick.count;
+    }
+    long total;
+};
+//--------------------------------------
+//  Timing
+//--------------------------------------
+double now()
+{
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+void report(string name, long iterations, double seconds)
+{
+    cout << "  " << name << ": " << (seconds * 1e9 / iterations) << " ns/op\n";
+}
+//--------------------------------------
+//  MAIN
+//--------------------------------------
+int main(int argc, char** argv)
+{
+    long iterations = argc > 1 ? atol(argv[1]) : 5000000;
+    cout << "\n-- benchmark, " << iterations << " iterations per case --\n";
+
+    Facade* facade = Facade::getInstance("benchmarkApplicationKey");
+    facade->registerCommand<Count>(n_name::POOLED_COMMAND, CommandLifetime::POOLED);
+    facade->registerCommand<Count>(n_name::TRANSIENT_COMMAND);
+    facade->registerMediator(new CountMediator(CountMediator::NAME));
+    for(int i = 0; i < n_name::COMMANDS; i++)
+        facade->registerCommand<Count>(n_name::MANY_COMMANDS + i, CommandLifetime::POOLED);
+
+    double start = now();
+    for(long i = 0; i < iterations; i++)
+        facade->sendNotification(n_name::POOLED_COMMAND);
+    report("sendNotification -> pooled command", iterations, now() - start);
+
+    start = now();
+    for(long i = 0; i < iterations; i++)
+        facade->sendNotification(n_name::TRANSIENT_COMMAND);
+    report("sendNotification -> transient command", iterations, now() - start);
+
+    start = now();
+    for(long i = 0; i < iterations; i++)
+        facade->sendNotification(n_name::MANY_COMMANDS + (int) (i * 7 % n_name::COMMANDS));
+    report("sendNotification -> 1 of 256 pooled commands", iterations, now() - start);
+
+    start = now();
+    for(long i = 0; i < iterations; i++)
+        facade->sendNotification(n_name::MEDIATOR);
+    report("sendNotification -> mediator", iterations, now() - start);
+
+    for(int i = 0; i < n_name::PROXIES; i++)
+    {
+        char name[32];
+        sprintf(name, "proxy%d", i);
+        facade->registerProxy(new NamedProxy(name));
+    }
+    facade->registerCommand<Retrieve>(n_name::RETRIEVE, CommandLifetime::POOLED);
+    start = now();
+    for(long i = 0; i < iterations; i++)
+        facade->sendNotification(n_name::RETRIEVE);
+    report("sendNotification -> command retrieving 4 of 32 proxies", iterations, now() - start);
+
+    void* bodies[64] = { 0 };
+    start = now();
+    for(long i = 0; i < iterations / 64; i++)
+        facade->sendNotifications(n_name::MEDIATOR, bodies, 64);
+    report("sendNotifications x64 -> mediator, per body", iterations / 64 * 64, now() - start);
+
+    TickCounter ticks;
+    facade->subscribe<Tick, TickCounter, &TickCounter::onTick>(&ticks);
+    Tick tick = { 1 };
+    start = now();
+    for(long i = 0; i < iterations; i++)
+        facade->sendNotification<Tick>(tick);
+    report("sendNotification<Tick> -> typed handler", iterations, now() - start);
+
+    start = now();
+    for(long i = 0; i < iterations / 64; i++)
+    {
+        for(int j = 0; j < 64; j++)
+            facade->postNotification(n_name::POOLED_COMMAND);
+        facade->pump();
+    }
+    report("postNotification + pump -> pooled command", iterations / 64 * 64, now() - start);
+
+    for(int i = 0; i < n_name::FAN_OUT_MEDIATORS; i++)
+    {
+        char name[32];
+        sprintf(name, "fanOut%d", i);
+        facade->registerMediator(new CountMediator(name, n_name::FAN_OUT));
+    }
+    start = now();
+    for(long i = 0; i < iterations / n_name::FAN_OUT_MEDIATORS; i++)
+        facade->sendNotification(n_name::FAN_OUT);
+    report("sendNotification -> 500 mediators, per mediator", iterations / n_name::FAN_OUT_MEDIATORS * n_name::FAN_OUT_MEDIATORS, now() - start);
+
+    // schedule a crowd of timeouts, then cancel them all
+    const long timeouts = 200000;
+    vector<Timer> timers(timeouts);
+    start = now();
+    for(long i = 0; i < timeouts; i++)
+        timers[i] = facade->sendNotificationAfter(1000 + i * 37 % 600000, n_name::MEDIATOR);
+    for(long i = 0; i < timeouts; i++)
+        facade->cancelTimer(timers[i]);
+    report("sendNotificationAfter + cancelTimer, 200000 pending", timeouts, now() - start);
+
+    // tear down a crowd of mediators sharing one interest
+    const long crowd = 20000;
+    vector<string> names;
+    for(long i = 0; i < crowd; i++)
+    {
+        char name[32];
+        sprintf(name, "crowd%ld", i);
+        names.push_back(name);
+        facade->registerMediator(new CountMediator(name));
+    }
+    start = now();
+    for(long i = 0; i < crowd; i++)
+        delete facade->removeMediator(names[i]);
+    report("removeMediator, 20000 on one interest", crowd, now() - start);
+
+    Facade::removeCore("benchmarkApplicationKey");
+    return 0;
+}
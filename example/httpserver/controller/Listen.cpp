@@ -14,6 +14,7 @@ using namespace PureMVC;
 void Listen::execute(INotification* note)
 {
     cout << "Listen::execute()\n";
-    SocketProxy* socketP = (SocketProxy*) getFacade()->retrieveProxy(SocketProxy::NAME);
-    socketP->beginListen();
+    if(! _socket)
+        _socket = ProxyRef<SocketProxy>(getFacade(), SocketProxy::NAME);
+    _socket->beginListen();
 }
\ No newline at end of file
@@ -18,22 +18,22 @@ void Set::execute(INotification* note)
 
     cout << "Set::execute(type:"<< n_type::toString[type] << ")\n";
 
-    IFacade* facade = getFacade();
-    SocketProxy* socketP = (SocketProxy*) facade->retrieveProxy(SocketProxy::NAME);
+    if(! _socket)
+        _socket = ProxyRef<SocketProxy>(getFacade(), SocketProxy::NAME);
     
     switch(type)
     {
         case n_type::CLI_ARGS:
         {
             CliArgs* cliargs = (CliArgs*) body;
-            socketP->setArgs(cliargs);
+            _socket->setArgs(cliargs);
         }
         break;
 
         case n_type::RESPONSE:
         {
             string reply = *(string*) body;
-            socketP->reply(reply);
+            _socket->reply(reply);
         }
         break;
     }
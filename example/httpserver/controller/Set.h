@@ -17,10 +17,15 @@
 
 #include "common.h"
 
+class SocketProxy;
+
 class Set : public PureMVC::SimpleCommand
 {
 public:
     void execute(PureMVC::INotification* note);
+private:
+    /// our socket proxy, looked up the first time we need it
+    PureMVC::ProxyRef<SocketProxy> _socket;
 };
 
 #endif
\ No newline at end of file
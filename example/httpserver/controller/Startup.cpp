@@ -30,13 +30,13 @@ void Startup::execute(INotification* note)
     IFacade* facade = this->getFacade();
     // register our mediators
     facade->registerMediator(new HttpMediator(HttpMediator::NAME));
-    // register our proxies
-    facade->registerProxy(new SocketProxy(SocketProxy::NAME));
+    // register our proxies, the socket proxy is made when it's first needed
+    facade->registerProxyFactory(SocketProxy::NAME, new ProxyFactory<SocketProxy>());
 
     // tell things we're done with registrations
     sendNotification(n_name::PATTERNS_REGISTERED);
     // send out the cliargs
     sendNotification(n_name::SET, cliargs, n_type::CLI_ARGS);
     // tell the Socket proxy to start listening
-    sendNotification(n_name::LISTEN);
+    postNotification(n_name::LISTEN);
 }
\ No newline at end of file
@@ -28,8 +28,9 @@ std::map<int, std::string> n_type::toString;
 void registerCommands(Facade* facade)
 {
     facade->registerCommand<Startup>(n_name::STARTUP);
-    facade->registerCommand<Set>(n_name::SET);
-    facade->registerCommand<Listen>(n_name::LISTEN);
+    // pooled, so the commands keep their proxy references between notifications
+    facade->registerCommand<Set>(n_name::SET, CommandLifetime::POOLED);
+    facade->registerCommand<Listen>(n_name::LISTEN, CommandLifetime::POOLED);
 }
 //--------------------------------------
 //  MAIN
@@ -51,6 +52,8 @@ int main(int argc, char** argv)
 	registerCommands(facade);
 	// startup the app by calling the startup command
 	facade->sendNotification(n_name::STARTUP, &cliArgs);
+	// serve requests one at a time, each LISTEN is posted back to the loop
+	facade->runEventLoop();
 
 	// cleanup the app for quitting
 	Facade::removeCore(applicationKey);
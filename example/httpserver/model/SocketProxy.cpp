@@ -134,8 +134,8 @@ void SocketProxy::reply(string response)
     // close the socket
     shutdown(_readSockfd, 2);
 
-    // start listening again
-    sendNotification(n_name::LISTEN);
+    // start listening again once this request has been unwound
+    postNotification(n_name::LISTEN);
 }
 /*                                                                            */
 void SocketProxy::error(string msg)
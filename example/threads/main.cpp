@@ -16,6 +16,7 @@
 #include <string>
 #include <pthread.h>
 #include <time.h>
+#include <unistd.h>
 #include "pmvcpp.h"
 
 using namespace std;
@@ -35,6 +36,7 @@ public:
         PATTERNS_REGISTERED,	// alerts the app that proxies and mediators have been registered
 		CREATE,					// create something
         DISPLAY,				// display something
+        COMPLETE,				// something has finished
         QUIT                    // quit
 	};
 	static map<int, string> toString;
@@ -45,6 +47,7 @@ public:
         n_name::toString[PATTERNS_REGISTERED] 	= "patterns registered";
         n_name::toString[CREATE] 				= "create";			    
         n_name::toString[DISPLAY] 				= "display";			    
+        n_name::toString[COMPLETE] 				= "complete";
 		n_name::toString[QUIT] 					= "quit";                       
 	}
 };
@@ -78,7 +81,7 @@ class ThreadProxy : public Proxy
 public:
 	static const string NAME;
 	
-	ThreadProxy(string proxyName) : Proxy(proxyName) {}
+	ThreadProxy(string proxyName) : Proxy(proxyName), completeThreads(0), totalThreads(0) {}
 	void onRegister()
 	{
 		cout << "ThreadProxy::onRegister()\n";
@@ -114,6 +117,12 @@ public:
 	{
 		return completeThreads == totalThreads;
 	}
+	// called on the main thread once a thread's completion is delivered
+	void threadComplete(int seconds)
+	{
+		cout << seconds << " second thread done.\n";
+		this->completeThreads++;
+	}
 private:	
 	// our vector of secthreads
 	vector<pthread_t> threads;
@@ -125,14 +134,14 @@ private:
 	{
 		ThreadProxy* threadProxy = static_cast<ThreadProxy*>(ptr);
 		int seconds = threadProxy->getTimeForNextThread();
-		clock_t endwait;
-		endwait = clock() + seconds * CLOCKS_PER_SEC;
-		while(clock() < endwait)
-		{
-			// we're waiting
-		}
-		cout << seconds << " second thread done.\n";
-		threadProxy->completeThreads++;
+		// we're waiting, without burning a cpu on it
+		sleep(seconds);
+		// report back through the core's inbox, the main thread
+		// delivers it the next time it pumps
+		Payload payload;
+		payload.set(seconds);
+		Facade* facade = dynamic_cast<Facade*>(threadProxy->getFacade());
+		facade->postToInbox(n_name::COMPLETE, payload, n_type::THREAD);
 		return 0;
 	}
 };
@@ -165,6 +174,7 @@ public:
 		
 		interests.push_back(n_name::PATTERNS_REGISTERED);
 		interests.push_back(n_name::DISPLAY);
+		interests.push_back(n_name::COMPLETE);
 		
 		return interests;
 	}
@@ -184,12 +194,21 @@ public:
 				this->promptUser();
 			break;
 			
+			case n_name::COMPLETE:
+			{
+				ThreadProxy* threadProxy = static_cast<ThreadProxy*>(this->getFacade()->retrieveProxy(ThreadProxy::NAME));
+				threadProxy->threadComplete(*(int*) note->getBody());
+			}
+			break;
+			
 			default:
 			{}
 		}
 	}
 	void promptUser()
 	{
+		// hear from any threads that finished while we were waiting on the user
+		this->getFacade()->pump();
 		cout << "\n\n";
 		int numThreads = this->getNumThreads();;
 		vector<int> secondList;
@@ -9,22 +9,166 @@
  */
 
 #include <iostream>
+#include <deque>
 #include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <sched.h>
 #include "pmvcpp.h"
 
 using namespace PureMVC;
 //--------------------------------------
+//  MultitonKey
+//--------------------------------------
+// the key names are a function static so that they are built on first
+// use, even when that use comes from another file's static initializers;
+// a deque never moves its elements, so name() can hand out references
+static std::deque<std::string>& multitonKeyNames()
+{
+    static std::deque<std::string> names(1, std::string());
+    return names;
+}
+static Mutex& multitonKeyMutex()
+{
+    static Mutex mutex;
+    return mutex;
+}
+// interned keys, probed without a lock. Keys are only ever added: an
+// entry is filled in before its id is published, and a grown table is
+// copied and the copy published, the old one kept for readers still in it.
+// Plain statics, zero before any dynamic initializer runs.
+struct MultitonKeyEntry
+{
+    size_t hash;
+    const std::string* name;
+    CoreId id;                  // EMPTY while the entry is unused
+};
+struct MultitonKeyTable
+{
+    size_t capacity;
+    MultitonKeyEntry* entries;
+    MultitonKeyTable* retired;
+};
+static MultitonKeyTable* multitonKeyTable = 0;
+static size_t multitonKeyCount = 0;
+static size_t multitonKeyHash(const std::string& key)
+{
+    // FNV-1a
+    size_t hash = 2166136261u;
+    for(size_t i = 0; i < key.size(); i++)
+        hash = (hash ^ (unsigned char) key[i]) * 16777619u;
+    return hash;
+}
+// the entry holding key, or the unused entry that ends its probe
+static MultitonKeyEntry* multitonKeyEntry(MultitonKeyTable* table, const std::string& key, size_t hash)
+{
+    size_t mask = table->capacity - 1;
+    size_t i = hash & mask;
+    while(__atomic_load_n(&table->entries[i].id, __ATOMIC_ACQUIRE) != MultitonKey::EMPTY)
+    {
+        if(table->entries[i].hash == hash && *table->entries[i].name == key)
+            break;
+        i = (i + 1) & mask;
+    }
+    return &table->entries[i];
+}
+static bool multitonKeyFind(const std::string& key, size_t hash, CoreId& id)
+{
+    MultitonKeyTable* table = __atomic_load_n(&multitonKeyTable, __ATOMIC_ACQUIRE);
+    if(table == (MultitonKeyTable*) 0)
+        return false;
+    id = __atomic_load_n(&multitonKeyEntry(table, key, hash)->id, __ATOMIC_ACQUIRE);
+    return id != MultitonKey::EMPTY;
+}
+// called with the mutex held, keeps at least half of the entries unused
+static void multitonKeyReserve()
+{
+    MultitonKeyTable* table = multitonKeyTable;
+    if(table != (MultitonKeyTable*) 0 && 2 * (multitonKeyCount + 1) <= table->capacity)
+        return;
+    MultitonKeyTable* grown = new MultitonKeyTable();
+    grown->capacity = table == (MultitonKeyTable*) 0 ? 16 : table->capacity * 2;
+    grown->entries = new MultitonKeyEntry[grown->capacity];
+    grown->retired = table;
+    for(size_t i = 0; i < grown->capacity; i++)
+        grown->entries[i].id = MultitonKey::EMPTY;
+    for(size_t i = 0; table != (MultitonKeyTable*) 0 && i < table->capacity; i++)
+    {
+        if(table->entries[i].id == MultitonKey::EMPTY)
+            continue;
+        *multitonKeyEntry(grown, *table->entries[i].name, table->entries[i].hash) = table->entries[i];
+    }
+    __atomic_store_n(&multitonKeyTable, grown, __ATOMIC_RELEASE);
+}
+const CoreId MultitonKey::EMPTY;
+
+CoreId MultitonKey::intern(const std::string& key)
+{
+    if(key.empty())
+        return MultitonKey::EMPTY;
+    // keys seen before are found without locking
+    size_t hash = multitonKeyHash(key);
+    CoreId id;
+    if(multitonKeyFind(key, hash, id))
+        return id;
+
+    ScopedLock lock(multitonKeyMutex());
+    if(multitonKeyFind(key, hash, id))
+        return id;
+    multitonKeyReserve();
+    std::deque<std::string>& names = multitonKeyNames();
+    id = (CoreId) names.size();
+    names.push_back(key);
+    MultitonKeyEntry* entry = multitonKeyEntry(multitonKeyTable, key, hash);
+    entry->hash = hash;
+    entry->name = &names.back();
+    __atomic_store_n(&entry->id, id, __ATOMIC_RELEASE);
+    multitonKeyCount++;
+    return id;
+}
+bool MultitonKey::lookup(const std::string& key, CoreId& id)
+{
+    if(key.empty())
+    {
+        id = MultitonKey::EMPTY;
+        return true;
+    }
+    return multitonKeyFind(key, multitonKeyHash(key), id);
+}
+const std::string& MultitonKey::name(CoreId id)
+{
+    ScopedLock lock(multitonKeyMutex());
+    return multitonKeyNames()[id];
+}
+// serializes the creation and initialization of core actors; recursive
+// because creating a Facade creates its Model, View and Controller
+static Mutex& coreCreationMutex()
+{
+    static Mutex mutex(true);
+    return mutex;
+}
+//--------------------------------------
 //  MultitonKeyHeir
 //--------------------------------------
+MultitonKeyHeir::MultitonKeyHeir()
+{
+    this->_coreId = MultitonKey::EMPTY;
+}
 void MultitonKeyHeir::setMultitonKey(std::string key)
 {
     this->_multitonKey = key;
+    this->_coreId = MultitonKey::intern(key);
 }
 
 std::string MultitonKeyHeir::getMultitonKey()
 {
     return this->_multitonKey;
 }
+
+CoreId MultitonKeyHeir::getCoreId()
+{
+    return this->_coreId;
+}
 //--------------------------------------
 //  Notification
 //--------------------------------------
@@ -38,15 +182,35 @@ Notification::Notification(int name, void* body)
 {
     this->name = name;
     this->setBody(body);
+    this->setType(0);
 }
 Notification::Notification(int name, int notificationType)
 {
     this->name = name;
+    this->setBody((void*) 0);
     this->setType(notificationType);
 }
 Notification::Notification(int name)
 {
     this->name = name;
+    this->setBody((void*) 0);
+    this->setType(0);
+}
+Notification::Notification(Notification const& notification)
+{
+    *this = notification;
+}
+Notification& Notification::operator=(Notification const& notification)
+{
+    if(&notification == this)
+        return *this;
+    this->name = notification.name;
+    this->type = notification.type;
+    this->body = notification.body;
+    // owned payloads are copied, shared ones gain a reference
+    if(this->payload.copy(notification.payload))
+        this->body = this->payload.data();
+    return *this;
 }
 int Notification::getName()
 {
@@ -54,8 +218,22 @@ int Notification::getName()
 }
 void Notification::setBody( void* body )
 {
+    this->payload.reset();
     this->body = body;
 }
+void Notification::takePayload( Payload& from )
+{
+    this->payload.transfer(from);
+    this->body = this->payload.data();
+}
+void Notification::copyTo( Notification& copy )
+{
+    copy = *this;
+}
+bool Notification::hasPayload()
+{
+    return ! this->payload.empty();
+}
 void* Notification::getBody()
 {
     return this->body;
@@ -68,9 +246,26 @@ int Notification::getType()
 {
     return this->type;
 }
+int Notification::allocateTypedName()
+{
+    static int next = Notification::FIRST_TYPED_NAME;
+    return __atomic_fetch_add(&next, 1, __ATOMIC_RELAXED);
+}
 //--------------------------------------
 //  Notifier
 //--------------------------------------
+// serializes Notifiers caching a facade, so that a facade and its
+// generation are never written over by halves
+static Mutex& notifierCacheMutex()
+{
+    static Mutex mutex;
+    return mutex;
+}
+Notifier::Notifier()
+{
+    this->facade = (IFacade*) 0;
+    this->facadeGeneration = 0;
+}
 void Notifier::sendNotification( int notificationName, void* body, int notificationType)
 {
     this->getFacade()->sendNotification(notificationName, body, notificationType);
@@ -87,13 +282,58 @@ void Notifier::sendNotification( int notificationName )
 {
     this->getFacade()->sendNotification(notificationName);
 }
+void Notifier::postNotification( int notificationName, void* body, int notificationType)
+{
+    this->getFacade()->postNotification(notificationName, body, notificationType);
+}
+void Notifier::postNotification( int notificationName, int notificationType )
+{
+    this->getFacade()->postNotification(notificationName, notificationType);
+}
+void Notifier::postNotification( int notificationName, void* body )
+{
+    this->getFacade()->postNotification(notificationName, body);
+}
+void Notifier::postNotification( int notificationName )
+{
+    this->getFacade()->postNotification(notificationName);
+}
+void Notifier::postNotification( int notificationName, Payload& payload, int notificationType )
+{
+    this->getFacade()->postNotification(notificationName, payload, notificationType);
+}
+void Notifier::postNotification( int notificationName, Payload& payload )
+{
+    this->getFacade()->postNotification(notificationName, payload);
+}
 void Notifier::initializeNotifier(std::string key)
 {
     this->setMultitonKey(key);
+    // resolve the facade now if its core is up, otherwise on first use
+    unsigned long generation = Facade::getCoreGeneration();
+    Facade* facade = Facade::find(this->getCoreId());
+    this->cacheFacade(facade, facade != (Facade*) 0 ? generation + 1 : 0);
 }
 IFacade* Notifier::getFacade()
 {
-    return Multiton<Facade>::instance(this->getMultitonKey());
+    // the generation is read on both sides of the facade, so a facade
+    // being cached by another thread is never taken for a cached one
+    unsigned long generation = Facade::getCoreGeneration();
+    unsigned long cached = __atomic_load_n(&this->facadeGeneration, __ATOMIC_ACQUIRE);
+    IFacade* facade = __atomic_load_n(&this->facade, __ATOMIC_ACQUIRE);
+    if(cached == generation + 1 && __atomic_load_n(&this->facadeGeneration, __ATOMIC_RELAXED) == cached)
+        return facade;
+    // only hands out a facade once it is initialized, creating its core if need be
+    facade = Facade::getInstance(this->getMultitonKey());
+    this->cacheFacade(facade, generation + 1);
+    return facade;
+}
+void Notifier::cacheFacade( IFacade* facade, unsigned long generation )
+{
+    ScopedLock lock(notifierCacheMutex());
+    __atomic_store_n(&this->facadeGeneration, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&this->facade, facade, __ATOMIC_RELEASE);
+    __atomic_store_n(&this->facadeGeneration, generation, __ATOMIC_RELEASE);
 }
 //--------------------------------------
 //  SimpleCommand
@@ -153,6 +393,39 @@ void* Proxy::getData()
     return this->data;
 }
 //--------------------------------------
+//  GRACE PERIOD
+//--------------------------------------
+GracePeriod::GracePeriod()
+{
+    this->epoch = 0;
+    this->readers[0] = 0;
+    this->readers[1] = 0;
+}
+unsigned int GracePeriod::enter()
+{
+    for(;;)
+    {
+        unsigned int epoch = __atomic_load_n(&this->epoch, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&this->readers[epoch & 1], 1, __ATOMIC_SEQ_CST);
+        // counted under the epoch still current, so a writer flipping it
+        // from now on will wait for us
+        if(__atomic_load_n(&this->epoch, __ATOMIC_SEQ_CST) == epoch)
+            return epoch & 1;
+        __atomic_sub_fetch(&this->readers[epoch & 1], 1, __ATOMIC_SEQ_CST);
+    }
+}
+void GracePeriod::leave( unsigned int token )
+{
+    __atomic_sub_fetch(&this->readers[token], 1, __ATOMIC_SEQ_CST);
+}
+void GracePeriod::wait()
+{
+    // readers entering from here on count towards the other parity
+    unsigned int epoch = __atomic_fetch_add(&this->epoch, 1, __ATOMIC_SEQ_CST);
+    while(__atomic_load_n(&this->readers[epoch & 1], __ATOMIC_SEQ_CST) != 0)
+        sched_yield();
+}
+//--------------------------------------
 //  Mediator
 //--------------------------------------
 Mediator::Mediator( std::string mediatorName, void* viewComponent )
@@ -180,58 +453,507 @@ void* Mediator::getViewComponent()
 {
     return this->viewComponent;
 }
+void Mediator::handleNotifications( int notificationName, void* const* bodies, size_t count, int notificationType )
+{
+    Notification notification(notificationName, notificationType);
+    for(size_t i = 0; i < count; i++)
+    {
+        notification.body = bodies[i];
+        this->handleNotification(&notification);
+    }
+}
 std::string Mediator::getName()
 {
     return this->mediatorName;
 }
 //--------------------------------------
+//  PROXY MAP
+//--------------------------------------
+const unsigned int ProxyMap::NONE;
+
+ProxyMap::ProxyMap()
+{
+    this->table = new Table();
+    this->table->capacity = 16;
+    this->table->entries = new Entry[16];
+    this->table->retired = (Table*) 0;
+    this->count = 0;
+}
+ProxyMap::~ProxyMap()
+{
+    while(this->table != (Table*) 0)
+    {
+        Table* retired = this->table->retired;
+        delete [] this->table->entries;
+        delete this->table;
+        this->table = retired;
+    }
+}
+size_t ProxyMap::hash( StringRef name )
+{
+    // FNV-1a
+    size_t hash = 2166136261u;
+    for(size_t i = 0; i < name.size(); i++)
+        hash = (hash ^ (unsigned char) name.data()[i]) * 16777619u;
+    return hash;
+}
+size_t ProxyMap::slot( const Table* table, StringRef name, size_t hash )
+{
+    // the entry holding name, or the empty entry that ends its probe;
+    // an entry's slot is published last, so once it is there so is the rest
+    size_t mask = table->capacity - 1;
+    size_t i = hash & mask;
+    while(__atomic_load_n(&table->entries[i].slot, __ATOMIC_ACQUIRE) != ProxyMap::NONE)
+    {
+        if(table->entries[i].hash == hash && name == table->entries[i].name)
+            break;
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+unsigned int ProxyMap::find( StringRef name ) const
+{
+    const Table* table = __atomic_load_n(&this->table, __ATOMIC_ACQUIRE);
+    return __atomic_load_n(&table->entries[ProxyMap::slot(table, name, ProxyMap::hash(name))].slot, __ATOMIC_ACQUIRE);
+}
+bool ProxyMap::insert( const std::string& name, unsigned int slot )
+{
+    size_t hash = ProxyMap::hash(name);
+    size_t i = ProxyMap::slot(this->table, name, hash);
+    if(this->table->entries[i].slot != ProxyMap::NONE)
+        return false;
+    // keep at least half of the entries empty so probes stay short
+    if(2 * (this->count + 1) > this->table->capacity)
+    {
+        this->grow();
+        i = ProxyMap::slot(this->table, name, hash);
+    }
+    Entry& entry = this->table->entries[i];
+    entry.hash = hash;
+    entry.name = name;
+    __atomic_store_n(&entry.slot, slot, __ATOMIC_RELEASE);
+    this->count++;
+    return true;
+}
+unsigned int ProxyMap::erase( StringRef name )
+{
+    Entry* entries = this->table->entries;
+    size_t mask = this->table->capacity - 1;
+    size_t i = ProxyMap::slot(this->table, name, ProxyMap::hash(name));
+    unsigned int slot = entries[i].slot;
+    if(slot == ProxyMap::NONE)
+        return slot;
+    // move back every entry after the hole that could have probed past it
+    size_t j = i;
+    for(;;)
+    {
+        j = (j + 1) & mask;
+        if(entries[j].slot == ProxyMap::NONE)
+            break;
+        size_t home = entries[j].hash & mask;
+        if(((j - home) & mask) >= ((j - i) & mask))
+        {
+            entries[i].hash = entries[j].hash;
+            entries[i].name.swap(entries[j].name);
+            __atomic_store_n(&entries[i].slot, entries[j].slot, __ATOMIC_RELEASE);
+            i = j;
+        }
+    }
+    entries[i].name.clear();
+    __atomic_store_n(&entries[i].slot, ProxyMap::NONE, __ATOMIC_RELEASE);
+    this->count--;
+    return slot;
+}
+size_t ProxyMap::size() const
+{
+    return this->count;
+}
+void ProxyMap::grow()
+{
+    // lookups may still be probing the old table, so copy rather than move
+    Table* table = this->table;
+    Table* grown = new Table();
+    grown->capacity = table->capacity * 2;
+    grown->entries = new Entry[grown->capacity];
+    grown->retired = table;
+    for(size_t i = 0; i < table->capacity; i++)
+    {
+        if(table->entries[i].slot == ProxyMap::NONE)
+            continue;
+        Entry& entry = grown->entries[ProxyMap::slot(grown, table->entries[i].name, table->entries[i].hash)];
+        entry.hash = table->entries[i].hash;
+        entry.name = table->entries[i].name;
+        entry.slot = table->entries[i].slot;
+    }
+    __atomic_store_n(&this->table, grown, __ATOMIC_RELEASE);
+}
+//--------------------------------------
 //  Model
 //--------------------------------------
-Model::Model()
-{}
+const unsigned int Model::FIRST_CHUNK;
+const int Model::SLOT_CHUNKS;
+
+Model::Model() : registration(true)
+{
+    for(int i = 0; i < Model::SLOT_CHUNKS; i++)
+        this->slotChunks[i] = (ProxySlot*) 0;
+    this->slotCount = 0;
+}
+Model::~Model()
+{
+    for(unsigned int i = 0; i < this->slotCount; i++)
+        delete this->slotAt(i).factory;
+    for(int i = 0; i < Model::SLOT_CHUNKS; i++)
+        delete [] this->slotChunks[i];
+}
 IModel* Model::getInstance(std::string key)
 {
     // if the instance already exists, return it.
-    if(Multiton<Model>::exists(key))
-        return Multiton<Model>::instance(key);
-    // if not, create it and initialize
-    Model* modelPtr = Multiton<Model>::instance(key);
+    CoreId id = MultitonKey::intern(key);
+    Model* existing = Multiton<Model>::find(id);
+    if(existing != (Model*) 0)
+        return existing;
+    ScopedLock lock(coreCreationMutex());
+    existing = Multiton<Model>::find(id);
+    if(existing != (Model*) 0)
+        return existing;
+    // if not, create it and initialize, and only then let others find it
+    Model* modelPtr = new Model();
     modelPtr->setMultitonKey(key);
-    return modelPtr;
+    Model* stored = Multiton<Model>::insert(id, modelPtr);
+    if(stored != modelPtr)
+        delete modelPtr;
+    return stored;
 }
 void Model::registerProxy( IProxy* proxy )
 {
     proxy->initializeNotifier(this->getMultitonKey());
-    if(! this->hasProxy(proxy->getProxyName()))
+    std::string proxyName = proxy->getProxyName();
+    {
+        ScopedLock lock(this->registration);
+        if(this->proxyMap.find(proxyName) != ProxyMap::NONE)
+            return;
+
+        unsigned int slot = this->allocateSlot();
+        __atomic_store_n(&this->slotAt(slot).proxy, proxy, __ATOMIC_RELEASE);
+        this->proxyMap.insert(proxyName, slot);
+    }
+    proxy->onRegister();
+}
+void Model::registerProxyFactory( std::string proxyName, IProxyFactory* factory )
+{
+    ScopedLock lock(this->registration);
+    if(this->proxyMap.find(proxyName) != ProxyMap::NONE)
+    {
+        delete factory;
+        return;
+    }
+    unsigned int slot = this->allocateSlot();
+    this->slotAt(slot).factory = factory;
+    this->slotAt(slot).name = proxyName;
+    this->proxyMap.insert(proxyName, slot);
+}
+// the proxies of one registerProxies call, shared by the calling thread
+// and the pool tasks helping it, and deleted by whichever lets go last
+class Model::ProxyBatch
+{
+public:
+    struct Node
+    {
+        IProxy* proxy;
+        unsigned int slot;
+        size_t waiting;     // dependencies whose onRegister hasn't returned
+        std::vector<size_t> dependents;
+    };
+    ProxyBatch( Model* model ) : model(model), remaining(0), references(1)
+    {
+        pthread_cond_init(&this->changed, NULL);
+    }
+    ~ProxyBatch()
+    {
+        pthread_cond_destroy(&this->changed);
+    }
+    // register a ready node, then make ready the nodes waiting on it
+    void run( size_t index )
+    {
+        Node& node = this->nodes[index];
+        node.proxy->onRegister();
+        this->model->publish(node.slot, node.proxy);
+
+        size_t readied = 0;
+        this->mutex.lock();
+        for(size_t i = 0; i < node.dependents.size(); i++)
+        {
+            if(--this->nodes[node.dependents[i]].waiting == 0)
+            {
+                this->ready.push_back(node.dependents[i]);
+                readied++;
+            }
+        }
+        this->remaining--;
+        pthread_cond_broadcast(&this->changed);
+        this->mutex.unlock();
+        this->help(readied);
+    }
+    // have the pool take some of the ready nodes
+    void help( size_t tasks );
+    void release()
+    {
+        if(__atomic_sub_fetch(&this->references, 1, __ATOMIC_ACQ_REL) == 0)
+            delete this;
+    }
+    Model* model;
+    std::vector<Node> nodes;
+    std::deque<size_t> ready;
+    size_t remaining;       // nodes whose onRegister hasn't returned
+    int references;
+    Mutex mutex;
+    pthread_cond_t changed;
+};
+// runs one ready node of a batch, unless the calling thread got to it first
+class Model::ProxyBatchTask : public ThreadPool::Task
+{
+public:
+    ProxyBatchTask( ProxyBatch* batch ) : batch(batch) {}
+    void run()
+    {
+        this->batch->mutex.lock();
+        bool found = ! this->batch->ready.empty();
+        size_t index = found ? this->batch->ready.front() : 0;
+        if(found)
+            this->batch->ready.pop_front();
+        this->batch->mutex.unlock();
+        if(found)
+            this->batch->run(index);
+        this->batch->release();
+    }
+private:
+    ProxyBatch* batch;
+};
+void Model::ProxyBatch::help( size_t tasks )
+{
+    for(size_t i = 0; i < tasks; i++)
+    {
+        __atomic_add_fetch(&this->references, 1, __ATOMIC_RELAXED);
+        ThreadPool::shared()->submit(new ProxyBatchTask(this));
+    }
+}
+void Model::registerProxies( const std::vector<ProxyRegistration>& registrations )
+{
+    ProxyBatch* batch = new ProxyBatch(this);
+    std::map<std::string, size_t> indices;
+    std::vector<size_t> registered;
+    // register every name, but publish no proxy until it has registered
+    this->registration.lock();
+    for(size_t i = 0; i < registrations.size(); i++)
+    {
+        IProxy* proxy = registrations[i].proxy;
+        proxy->initializeNotifier(this->getMultitonKey());
+        std::string proxyName = proxy->getProxyName();
+        if(this->proxyMap.find(proxyName) != ProxyMap::NONE)
+            continue;
+        ProxyBatch::Node node;
+        node.proxy = proxy;
+        node.slot = this->allocateSlot();
+        __atomic_store_n(&this->slotAt(node.slot).pending, true, __ATOMIC_RELAXED);
+        node.waiting = 0;
+        this->proxyMap.insert(proxyName, node.slot);
+        indices[proxyName] = batch->nodes.size();
+        batch->nodes.push_back(node);
+        registered.push_back(i);
+    }
+    this->registration.unlock();
+    for(size_t n = 0; n < batch->nodes.size(); n++)
+    {
+        const std::vector<std::string>& dependencies = registrations[registered[n]].dependencies;
+        for(size_t j = 0; j < dependencies.size(); j++)
+        {
+            std::map<std::string, size_t>::iterator dependency = indices.find(dependencies[j]);
+            if(dependency == indices.end())
+                continue;
+            batch->nodes[dependency->second].dependents.push_back(n);
+            batch->nodes[n].waiting++;
+        }
+    }
+
+    // whatever a walk from the nodes without dependencies can't reach is
+    // in or behind a cycle and is left for later
+    std::vector<size_t> waiting(batch->nodes.size());
+    std::vector<size_t> reached;
+    for(size_t i = 0; i < batch->nodes.size(); i++)
+    {
+        waiting[i] = batch->nodes[i].waiting;
+        if(waiting[i] == 0)
+            reached.push_back(i);
+    }
+    for(size_t i = 0; i < reached.size(); i++)
+    {
+        const std::vector<size_t>& dependents = batch->nodes[reached[i]].dependents;
+        for(size_t j = 0; j < dependents.size(); j++)
+            if(--waiting[dependents[j]] == 0)
+                reached.push_back(dependents[j]);
+    }
+    std::vector<bool> cyclic(batch->nodes.size(), true);
+    for(size_t i = 0; i < reached.size(); i++)
+        cyclic[reached[i]] = false;
+    for(size_t i = 0; i < batch->nodes.size(); i++)
+        if(batch->nodes[i].waiting == 0)
+            batch->ready.push_back(i);
+    batch->remaining = reached.size();
+
+    // the pool takes what it can, this thread does the rest
+    batch->help(batch->ready.size() > 0 ? batch->ready.size() - 1 : 0);
+    batch->mutex.lock();
+    while(batch->remaining > 0)
     {
-        this->proxyMap[proxy->getProxyName()] = proxy;
-        proxy->onRegister();
+        if(batch->ready.empty())
+        {
+            pthread_cond_wait(&batch->changed, batch->mutex.native());
+            continue;
+        }
+        size_t index = batch->ready.front();
+        batch->ready.pop_front();
+        batch->mutex.unlock();
+        batch->run(index);
+        batch->mutex.lock();
+    }
+    batch->mutex.unlock();
+
+    for(size_t i = 0; i < batch->nodes.size(); i++)
+    {
+        if(! cyclic[i])
+            continue;
+        ProxyBatch::Node& node = batch->nodes[i];
+        node.proxy->onRegister();
+        this->publish(node.slot, node.proxy);
     }
+    batch->release();
 }
-IProxy* Model::retrieveProxy( std::string proxyName )
+IProxy* Model::retrieveProxy( StringRef proxyName )
 {
-    return this->proxyMap[proxyName];
+    unsigned int slot = this->proxyMap.find(proxyName);
+    if(slot == ProxyMap::NONE)
+        return (IProxy*) 0;
+    return this->proxyIn(slot);
 }
-bool Model::hasProxy( std::string proxyName )
+bool Model::hasProxy( StringRef proxyName )
 {
-    return ! (this->proxyMap.find(proxyName) == this->proxyMap.end());
+    // a batch proxy only counts once it can be retrieved
+    unsigned int slot = this->proxyMap.find(proxyName);
+    return slot != ProxyMap::NONE && ! __atomic_load_n(&this->slotAt(slot).pending, __ATOMIC_ACQUIRE);
 }
-IProxy* Model::removeProxy( std::string proxyName )
+IProxy* Model::removeProxy( StringRef proxyName )
 {
     //std::cout << "removeProxy()\n";
-    // if this proxy has not been registered, return a null pointer
-    if(! this->hasProxy(proxyName))
-        return (IProxy*) 0;
-
-    // get the proxy
-    IProxy* proxy = this->proxyMap[proxyName];
-    // remove the proxy from the map
-    this->proxyMap.erase(proxyName);
+    IProxy* proxy;
+    {
+        ScopedLock lock(this->registration);
+        // remove the proxy from the map
+        unsigned int slot = this->proxyMap.erase(proxyName);
+        // if this proxy has not been registered, return a null pointer
+        if(slot == ProxyMap::NONE)
+            return (IProxy*) 0;
+        proxy = this->slotAt(slot).proxy;
+        this->freeSlot(slot);
+    }
+    // a lazy proxy that was never retrieved was never constructed either
+    if(proxy == (IProxy*) 0)
+        return proxy;
     // alert the proxy that it's been removed
     proxy->onRemove();
 
     return proxy;
 }
+ProxyHandle Model::retrieveProxyHandle( StringRef proxyName )
+{
+    unsigned int slot = this->proxyMap.find(proxyName);
+    if(slot == ProxyMap::NONE || this->proxyIn(slot) == (IProxy*) 0)
+        return ProxyHandle();
+    return ProxyHandle(slot, __atomic_load_n(&this->slotAt(slot).generation, __ATOMIC_RELAXED));
+}
+IProxy* Model::retrieveProxy( ProxyHandle handle )
+{
+    if(handle.slot >= __atomic_load_n(&this->slotCount, __ATOMIC_ACQUIRE)
+        || __atomic_load_n(&this->slotAt(handle.slot).generation, __ATOMIC_RELAXED) != handle.generation)
+        return (IProxy*) 0;
+    return this->proxyIn(handle.slot);
+}
+Model::ProxySlot& Model::slotAt( unsigned int slot )
+{
+    // chunk k starts at slot (FIRST_CHUNK << k) - FIRST_CHUNK
+    unsigned int offset = slot + Model::FIRST_CHUNK;
+    int chunk = 31 - __builtin_clz(offset) - 4;
+    return this->slotChunks[chunk][offset - (Model::FIRST_CHUNK << chunk)];
+}
+unsigned int Model::allocateSlot()
+{
+    unsigned int slot;
+    if(! this->freeProxySlots.empty())
+    {
+        slot = this->freeProxySlots.back();
+        this->freeProxySlots.pop_back();
+        return slot;
+    }
+    slot = this->slotCount;
+    unsigned int offset = slot + Model::FIRST_CHUNK;
+    int chunk = 31 - __builtin_clz(offset) - 4;
+    if(this->slotChunks[chunk] == (ProxySlot*) 0)
+        this->slotChunks[chunk] = new ProxySlot[Model::FIRST_CHUNK << chunk];
+    // handles check the count, so the chunk is there before the slot is
+    __atomic_store_n(&this->slotCount, slot + 1, __ATOMIC_RELEASE);
+    return slot;
+}
+void Model::publish( unsigned int slot, IProxy* proxy )
+{
+    // the proxy goes in before the slot stops pending, so whoever sees
+    // it has stopped finds the proxy
+    ProxySlot& published = this->slotAt(slot);
+    __atomic_store_n(&published.proxy, proxy, __ATOMIC_RELEASE);
+    __atomic_store_n(&published.pending, false, __ATOMIC_RELEASE);
+}
+void Model::freeSlot( unsigned int slot )
+{
+    // the new generation invalidates outstanding handles
+    ProxySlot& freed = this->slotAt(slot);
+    delete freed.factory;
+    freed.factory = (IProxyFactory*) 0;
+    __atomic_store_n(&freed.proxy, (IProxy*) 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&freed.pending, false, __ATOMIC_RELAXED);
+    freed.name.clear();
+    unsigned int generation = freed.generation + 1;
+    __atomic_store_n(&freed.generation, generation == 0 ? 1 : generation, __ATOMIC_RELAXED);
+    this->freeProxySlots.push_back(slot);
+}
+IProxy* Model::proxyIn( unsigned int slot )
+{
+    // the proxy is published only once it is registered, so once it is
+    // there no lock is needed
+    IProxy* proxy = __atomic_load_n(&this->slotAt(slot).proxy, __ATOMIC_ACQUIRE);
+    if(proxy != (IProxy*) 0)
+        return proxy;
+
+    ScopedLock lock(this->registration);
+    ProxySlot* lazy = &this->slotAt(slot);
+    proxy = __atomic_load_n(&lazy->proxy, __ATOMIC_ACQUIRE);
+    if(proxy != (IProxy*) 0)
+        return proxy;
+    // its own onRegister, on this thread, gets it as it is
+    if(lazy->constructing != (IProxy*) 0)
+        return lazy->constructing;
+    if(lazy->factory == (IProxyFactory*) 0)
+        return (IProxy*) 0;
+
+    proxy = lazy->factory->create(lazy->name);
+    proxy->initializeNotifier(this->getMultitonKey());
+    lazy->constructing = proxy;
+    // it may register proxies of its own, which leaves this slot where it is
+    proxy->onRegister();
+    lazy->constructing = (IProxy*) 0;
+    delete lazy->factory;
+    lazy->factory = (IProxyFactory*) 0;
+    __atomic_store_n(&lazy->proxy, proxy, __ATOMIC_RELEASE);
+    return proxy;
+}
 void Model::removeModel( std::string key )
 {
     Multiton<Model>::erase(key);
@@ -239,76 +961,181 @@ void Model::removeModel( std::string key )
 //--------------------------------------
 //  View
 //--------------------------------------
+const int View::DEFAULT_DENSE_NAME_LIMIT;
+
 View::View( )
 {
+    this->denseNameLimit = View::DEFAULT_DENSE_NAME_LIMIT;
+    this->epoch = 0;
+}
+View::~View()
+{
+    for(size_t i = 0; i < this->denseObservers.size(); i++)
+        delete this->denseObservers[i];
+    for(size_t i = 0; i < this->typedObservers.size(); i++)
+        delete this->typedObservers[i];
 }
 IView* View::getInstance(std::string key)
 {
     // if the instance already exists, simply return it
-    if(Multiton<View>::exists(key))
-        return Multiton<View>::instance(key);
+    CoreId id = MultitonKey::intern(key);
+    View* existing = Multiton<View>::find(id);
+    if(existing != (View*) 0)
+        return existing;
+    ScopedLock lock(coreCreationMutex());
+    existing = Multiton<View>::find(id);
+    if(existing != (View*) 0)
+        return existing;
     // if the instance needs to be created, do so and take
-    // care of some initialization
-    View* viewPtr = Multiton<View>::instance(key);
+    // care of some initialization, and only then let others find it
+    View* viewPtr = new View();
     viewPtr->setMultitonKey(key);
-    return viewPtr;
+    View* stored = Multiton<View>::insert(id, viewPtr);
+    if(stored != viewPtr)
+        delete viewPtr;
+    return stored;
+}
+Subscription View::registerObserver ( int notificationName, IObserverRestricted* observer )
+{
+    return this->registerObserver(notificationName, Delegate(observer));
 }
-void View::registerObserver ( int notificationName, IObserverRestricted* observer )
+Subscription View::registerObserver ( int notificationName, Delegate delegate )
 {
-    if(! this->existsObserversInterestedIn(notificationName))
+    ObserverList& observers = this->observersFor(notificationName);
+
+    unsigned int slot;
+    if(! this->freeSlots.empty())
     {
-        std::vector<IObserverRestricted*> observerVector;
-        observerVector.push_back(observer);
-        this->observerMap[notificationName] = observerVector;
+        slot = this->freeSlots.back();
+        this->freeSlots.pop_back();
     }
     else
     {
-        this->observerMap[notificationName].push_back(observer);
+        SubscriptionSlot fresh;
+        fresh.generation = 1;
+        slot = (unsigned int) this->subscriptionSlots.size();
+        this->subscriptionSlots.push_back(fresh);
     }
+    this->subscriptionSlots[slot].index = observers.entries.size();
+
+    ObserverEntry entry;
+    entry.delegate = delegate;
+    entry.removedAt = 0;
+    entry.slot = slot;
+    observers.entries.push_back(entry);
+    return Subscription(notificationName, slot, this->subscriptionSlots[slot].generation);
 }
 void View::notifyObservers( INotification* notification )
 {
     int noteName = notification->getName();
-    if(this->existsObserversInterestedIn(noteName))
-    {
-        // there was some stuff about the reference array changing while
-        // running this loop, although i don't see how that could happen
-        // until we add threads to this architecture - so i'm keeping
-        // it simple here
-        std::vector<IObserverRestricted*> observers = this->observerMap[noteName];
-        std::vector<IObserverRestricted*>::iterator it;
-        for(it = observers.begin(); it != observers.end(); it++)
-        {
-            (*it)->notifyObserver(notification);
-        }
+    ObserverList* observers = this->findObservers(noteName);
+    if(observers == (ObserverList*) 0 || observers->entries.empty())
+        return;
+
+    // observers may register or remove observers on this list while we
+    // notify them, so rather than copying the list we walk it by index:
+    // entries appended after we started lie past 'count', and entries
+    // removed after we started carry a later epoch than 'started'
+    unsigned long started = ++this->epoch;
+    size_t count = observers->entries.size();
+    ObserverDispatch dispatch(this, noteName, observers);
+    for(size_t i = 0; i < count; i++)
+    {
+        const ObserverEntry& entry = observers->entries[i];
+        if(entry.removedAt == 0 || entry.removedAt > started)
+            entry.delegate(notification);
     }
 }
 void View::removeObserver( int notificationName, intptr_t contextAddress )
 {
-    if(this->existsObserversInterestedIn(notificationName))
+    ObserverList* observers = this->findObservers(notificationName);
+    if(observers == (ObserverList*) 0)
+        return;
+
+    for(size_t i = 0; i < observers->entries.size(); i++)
     {
-        std::vector<IObserverRestricted*> observers = this->observerMap[notificationName];
-        std::vector<IObserverRestricted*>::iterator it;
+        ObserverEntry& entry = observers->entries[i];
+        if(entry.removedAt != 0)
+            continue;
+        // this is tricky because in c++ we can't compare arbitrary types
+        // we have to downcast the IObserverRestricteds to their derived classes
+        // in order to properly compare them. someone may object to this -
+        // i know it's programming taboo - so by all means figure out a
+        // better way to do this, however i'm sure  it will
+        // involve refactoring the base classes
+        if(entry.delegate.compareNotifyContext(contextAddress) == true)
+        {
+            this->removeEntry(notificationName, observers, i);
+            return;
+        }
+    }
+}
+void View::removeObserver( Subscription subscription )
+{
+    // a stale handle's slot has moved on to a later generation
+    if(subscription.slot >= this->subscriptionSlots.size()
+        || this->subscriptionSlots[subscription.slot].generation != subscription.generation)
+        return;
+    ObserverList* observers = this->findObservers(subscription.notificationName);
+    if(observers == (ObserverList*) 0)
+        return;
+    this->removeEntry(subscription.notificationName, observers, this->subscriptionSlots[subscription.slot].index);
+}
+void View::removeEntry(int notificationName, ObserverList* observers, size_t index)
+{
+    ObserverEntry& entry = observers->entries[index];
+    // notifications already walking this list still reach the entry
+    entry.removedAt = ++this->epoch;
+    observers->removed++;
+
+    // free the slot, the new generation invalidates outstanding handles
+    SubscriptionSlot& slot = this->subscriptionSlots[entry.slot];
+    if(++slot.generation == 0)
+        slot.generation = 1;
+    this->freeSlots.push_back(entry.slot);
+
+    // compacting only once half the list is dead keeps removal amortized O(1)
+    if(observers->dispatching == 0 && observers->removed * 2 >= observers->entries.size())
+        this->compactObservers(notificationName, observers);
+}
+// handleNotification comes from INotificationHandler, but observers of
+// a mediator are identified by its IMediator address
+static void notifyMediator( void* mediator, INotification* notification )
+{
+    ((IMediator*) mediator)->handleNotification(notification);
+}
+void View::notifyObserversBatch( int notificationName, void* const* bodies, size_t count, int notificationType )
+{
+    ObserverList* observers = this->findObservers(notificationName);
+    if(count == 0 || observers == (ObserverList*) 0 || observers->entries.empty())
+        return;
 
-        for(it = observers.begin(); it != observers.end(); it++)
+    // the same rules as notifyObservers, applied once for the batch
+    unsigned long started = ++this->epoch;
+    size_t observerCount = observers->entries.size();
+    Notification notification(notificationName, notificationType);
+    ObserverDispatch dispatch(this, notificationName, observers);
+    for(size_t i = 0; i < observerCount; i++)
+    {
+        // copied, registering an observer may move the entries
+        const ObserverEntry entry = observers->entries[i];
+        if(entry.removedAt != 0 && entry.removedAt <= started)
+            continue;
+        if(entry.delegate.uses(&notifyMediator))
         {
-            // this is tricky because in c++ we can't compare arbitrary types
-            // we have to downcast the IObserverRestricteds to their derived classes
-            // in order to properly compare them. someone may object to this -
-            // i know it's programming taboo - so by all means figure out a
-            // better way to do this, however i'm sure  it will
-            // involve refactoring the base classes
-            if((*it)->compareNotifyContext(contextAddress) == true)
+            // batches are a Mediator's, other IMediators get them one by one
+            Mediator* mediator = dynamic_cast<Mediator*>((IMediator*) entry.delegate.getContext());
+            if(mediator != (Mediator*) 0)
             {
-                observers.erase(it);
-                break;
+                mediator->handleNotifications(notificationName, bodies, count, notificationType);
+                continue;
             }
         }
-        
-        this->observerMap[notificationName] = observers;
-
-        if(observers.size() == (size_t) 0)
-           this->observerMap.erase(notificationName);
+        for(size_t j = 0; j < count; j++)
+        {
+            notification.body = bodies[j];
+            entry.delegate(&notification);
+        }
     }
 }
 void View::registerMediator( IMediator* mediator )
@@ -324,12 +1151,13 @@ void View::registerMediator( IMediator* mediator )
     std::vector<int> interests = mediator->listNotificationInterests();
     if(interests.size() > (size_t) 0)
     {
-        // create an observer functor for the mediator
-        Observer<IMediator>* observer = new Observer<IMediator>(&IMediator::handleNotification, mediator);
-        // register this observer for every notification the mediator is interested in
+        // bind the mediator's handler, nothing to allocate
+        Delegate delegate((void*) mediator, &notifyMediator);
+        // register it for every notification the mediator is interested in
+        std::vector<Subscription>& subscriptions = this->mediatorSubscriptions[mediator->getMediatorName()];
         for (int i = 0; i < (int) interests.size(); i++)
         {
-            this->registerObserver(interests[i], observer);
+            subscriptions.push_back(this->registerObserver(interests[i], delegate));
         }
 
 
@@ -348,16 +1176,15 @@ IMediator* View::removeMediator( std::string mediatorName )
         return (IMediator*) 0;
     // get the mediator
     IMediator* mediator = this->mediatorMap[mediatorName];
-    // get the mediators interests
-    std::vector<int> interests = mediator->listNotificationInterests();
-    if(interests.size() > (size_t) 0)
+    // remove the mediator's observer functor from every list it was registered on
+    std::map<std::string, std::vector<Subscription> >::iterator subscriptions = this->mediatorSubscriptions.find(mediatorName);
+    if(subscriptions != this->mediatorSubscriptions.end())
     {
-        std::vector<std::string>::iterator it;
-        for (int i = 0; i < (int) interests.size(); i++)
+        for (size_t i = 0; i < subscriptions->second.size(); i++)
         {
-            // remove the mediator's observer functor listed for this notification
-            this->removeObserver(interests[i], (intptr_t) &*mediator);
+            this->removeObserver(subscriptions->second[i]);
         }
+        this->mediatorSubscriptions.erase(subscriptions);
     }
     // remove the mediator from the map
     this->mediatorMap.erase(mediatorName);
@@ -374,64 +1201,1150 @@ void View::removeView( std::string key )
 {
     Multiton<View>::erase(key);
 }
+void View::setDenseNameLimit( int limit )
+{
+    if(limit < 0)
+        limit = 0;
+    // move every list into the sparse map, then back out into the new range
+    for(size_t i = 0; i < this->denseObservers.size(); i++)
+    {
+        ObserverList* list = this->denseObservers[i];
+        if(list != (ObserverList*) 0 && ! list->entries.empty())
+            this->observerMap[(int) i] = *list;
+        delete list;
+    }
+    this->denseObservers.clear();
+    this->denseNameLimit = limit;
+
+    std::map<int, ObserverList>::iterator it = this->observerMap.begin();
+    while(it != this->observerMap.end() && it->first < limit)
+    {
+        if(it->first >= 0)
+        {
+            this->observersFor(it->first) = it->second;
+            this->observerMap.erase(it++);
+        }
+        else
+            it++;
+    }
+}
+int View::getDenseNameLimit()
+{
+    return this->denseNameLimit;
+}
 bool View::existsObserversInterestedIn(int notificationName)
 {
-    return this->observerMap.find(notificationName) != this->observerMap.end();
+    ObserverList* observers = this->findObservers(notificationName);
+    return observers != (ObserverList*) 0 && observers->entries.size() > observers->removed;
 }
-//--------------------------------------
-//  Controller
-//--------------------------------------
-Controller::Controller()
+View::ObserverList* View::findObservers(int notificationName)
 {
+    // the unsigned compare also rejects negative names
+    if((size_t) (unsigned int) notificationName < this->denseObservers.size())
+        return this->denseObservers[notificationName];
+    if(notificationName >= 0 && notificationName < this->denseNameLimit)
+        return (ObserverList*) 0;
+    // typed names sit at the bottom of the int range, in a table of their own
+    size_t typed = (unsigned int) notificationName - (unsigned int) Notification::FIRST_TYPED_NAME;
+    if(typed < this->typedObservers.size())
+        return this->typedObservers[typed];
+
+    std::map<int, ObserverList>::iterator it = this->observerMap.find(notificationName);
+    if(it == this->observerMap.end())
+        return (ObserverList*) 0;
+    return &it->second;
 }
-IController* Controller::getInstance(std::string key)
+View::ObserverDispatch::ObserverDispatch( View* view, int notificationName, ObserverList* observers )
+    : view(view), notificationName(notificationName), observers(observers)
 {
-    // if the instance already exists, simply return it
-    if(Multiton<Controller>::exists(key))
-        return Multiton<Controller>::instance(key);
-    // if the instance needs to be created, do so and take
-    // care of some initialization
-    Controller* contPtr = Multiton<Controller>::instance(key);
-    contPtr->setMultitonKey(key);
-    contPtr->initializeController();
-    return contPtr;
+    this->observers->dispatching++;
 }
-bool Controller::hasCommand( int notificationName )
+View::ObserverDispatch::~ObserverDispatch()
 {
-    return ! (this->commandMap.find(notificationName) == this->commandMap.end());
+    // compacting only once half the list is dead keeps removal amortized O(1)
+    if(--this->observers->dispatching == 0 && this->observers->removed > 0
+        && this->observers->removed * 2 >= this->observers->entries.size())
+        this->view->compactObservers(this->notificationName, this->observers);
 }
-void Controller::removeCommand( int notificationName )
+void View::compactObservers(int notificationName, ObserverList* observers)
 {
-    if(this->hasCommand(notificationName))
+    if(observers->removed > 0)
     {
-        // remove observer from view
-        this->view->removeObserver(notificationName, (intptr_t) &*this);
-        // remove null command ptr from map
-        this->commandMap.erase(notificationName);
+        std::vector<ObserverEntry>::iterator kept = observers->entries.begin();
+        std::vector<ObserverEntry>::iterator it;
+        for(it = observers->entries.begin(); it != observers->entries.end(); it++)
+        {
+            if(it->removedAt != 0)
+                continue;
+            // removed entries gave up their slot, live ones follow their entry
+            this->subscriptionSlots[it->slot].index = kept - observers->entries.begin();
+            *kept++ = *it;
+        }
+        observers->entries.erase(kept, observers->entries.end());
+        observers->removed = 0;
     }
+
+    // dense and typed lists stay allocated, their slot is reused on the next registration
+    if(observers->entries.empty() && (notificationName < 0 || notificationName >= this->denseNameLimit))
+        this->observerMap.erase(notificationName);
 }
-void Controller::removeController( std::string key )
-{
-    Multiton<Controller>::erase(key);
-}
-void Controller::initializeController( )
+View::ObserverList& View::observersFor(int notificationName)
 {
-    this->view = View::getInstance(this->getMultitonKey());
+    std::vector<ObserverList*>* table = &this->denseObservers;
+    size_t index = (size_t) notificationName;
+    if(notificationName < 0 || notificationName >= this->denseNameLimit)
+    {
+        table = &this->typedObservers;
+        index = (unsigned int) notificationName - (unsigned int) Notification::FIRST_TYPED_NAME;
+        if(index >= (size_t) Notification::MAX_TYPED_NAMES)
+            return this->observerMap[notificationName];
+    }
+
+    if(index >= table->size())
+        table->resize(index + 1, (ObserverList*) 0);
+    ObserverList*& list = (*table)[index];
+    if(list == (ObserverList*) 0)
+        list = new ObserverList();
+    return *list;
 }
 //--------------------------------------
-//  FACADE
+//  Controller
 //--------------------------------------
-Facade::Facade()
+// executes one PARALLEL command on the pool
+class Controller::CommandTask : public ThreadPool::Task
 {
-	this->model = (IModel*) 0;
-	this->view = (IView*) 0;
+public:
+    CommandTask(Controller* controller, ICommandFactory* factory, INotification* note)
+        : note(note->getName(), note->getBody(), note->getType())
+    {
+        this->controller = controller;
+        this->factory = factory;
+        // a payload is copied or shared, and outlives the sender
+        Notification* source = dynamic_cast<Notification*>(note);
+        if(source != (Notification*) 0)
+            this->note = *source;
+    }
+    void run()
+    {
+        ICommand* command = this->factory->acquire();
+        command->execute(&this->note);
+        this->factory->release(command);
+        __atomic_sub_fetch(&this->controller->executingInPool, 1, __ATOMIC_RELEASE);
+    }
+private:
+    Controller* controller;
+    ICommandFactory* factory;
+    // the sender's notification is gone by now, so keep a copy
+    Notification note;
+};
+// counts an inline command executing, and hands it back to its factory
+// once it is done, even if it throws
+class Controller::ExecutionScope
+{
+public:
+    ExecutionScope(Controller* controller, ICommandFactory* factory, ICommand* command)
+    {
+        this->controller = controller;
+        this->factory = factory;
+        this->command = command;
+        this->controller->executing++;
+    }
+    ~ExecutionScope()
+    {
+        this->controller->executing--;
+        // hand it back, transient commands get rid of the evidence
+        this->factory->release(this->command);
+        if(this->controller->executing == 0 && ! this->controller->retiredFactories.empty())
+            this->controller->deleteRetiredFactories();
+    }
+private:
+    ExecutionScope(ExecutionScope const&);
+    ExecutionScope& operator=(ExecutionScope const&);
+    Controller* controller;
+    ICommandFactory* factory;
+    ICommand* command;
+};
+Controller::Controller()
+{
+    this->executing = 0;
+    this->executingInPool = 0;
+}
+IController* Controller::getInstance(std::string key)
+{
+    // if the instance already exists, simply return it
+    CoreId id = MultitonKey::intern(key);
+    Controller* existing = Multiton<Controller>::find(id);
+    if(existing != (Controller*) 0)
+        return existing;
+    ScopedLock lock(coreCreationMutex());
+    existing = Multiton<Controller>::find(id);
+    if(existing != (Controller*) 0)
+        return existing;
+    // if the instance needs to be created, do so and take
+    // care of some initialization, and only then let others find it
+    Controller* contPtr = new Controller();
+    contPtr->setMultitonKey(key);
+    contPtr->initializeController();
+    Controller* stored = Multiton<Controller>::insert(id, contPtr);
+    if(stored != contPtr)
+        delete contPtr;
+    return stored;
+}
+void Controller::executeCommand( INotification* note )
+{
+    ICommandFactory* factory = this->findFactory(note->getName());
+    // if this command isn't listed, abort
+    if(factory == (ICommandFactory*) 0)
+        return;
+    if(factory->isParallel())
+    {
+        __atomic_add_fetch(&this->executingInPool, 1, __ATOMIC_RELAXED);
+        ThreadPool::shared()->submit(new CommandTask(this, factory, note));
+        return;
+    }
+    // get an instance of the command from its factory
+    ICommand* command = factory->acquire();
+    ExecutionScope scope(this, factory, command);
+    command->execute(note);
+}
+bool Controller::hasCommand( int notificationName )
+{
+    return this->findFactory(notificationName) != (ICommandFactory*) 0;
+}
+void Controller::removeCommand( int notificationName )
+{
+    ICommandFactory* factory = this->findFactory(notificationName);
+    if(factory == (ICommandFactory*) 0)
+        return;
+
+    // remove observer from view
+    std::map<int, Subscription>::iterator subscription = this->commandSubscriptions.find(notificationName);
+    if(subscription != this->commandSubscriptions.end())
+    {
+        this->view->removeObserver(subscription->second);
+        this->commandSubscriptions.erase(subscription);
+    }
+    // remove the command's factory from the table
+    if(notificationName >= 0 && (size_t) notificationName < this->denseCommands.size())
+        this->denseCommands[notificationName] = (ICommandFactory*) 0;
+    else
+        this->commandMap.erase(notificationName);
+    // a command the factory made may be the one removing it, or may
+    // still be queued on the pool, so it has to outlive the execution
+    this->retiredFactories.push_back(factory);
+    if(this->executing == 0)
+        this->deleteRetiredFactories();
+}
+void Controller::addFactory( int notificationName, ICommandFactory* factory )
+{
+    // register the controller with the view for this notification
+    Delegate delegate = Delegate::bind<Controller, &Controller::executeCommand>(this);
+    this->commandSubscriptions[notificationName] = this->view->registerObserver(notificationName, delegate);
+
+    // index the same names the view does, a name already indexed stays put
+    View* view = dynamic_cast<View*>(this->view);
+    int denseNameLimit = view != (View*) 0 ? view->getDenseNameLimit() : View::DEFAULT_DENSE_NAME_LIMIT;
+    if(notificationName >= 0 && (notificationName < denseNameLimit || (size_t) notificationName < this->denseCommands.size()))
+    {
+        if((size_t) notificationName >= this->denseCommands.size())
+            this->denseCommands.resize(notificationName + 1, (ICommandFactory*) 0);
+        this->denseCommands[notificationName] = factory;
+    }
+    else
+        this->commandMap[notificationName] = factory;
+}
+ICommandFactory* Controller::findFactory( int notificationName )
+{
+    // the unsigned compare also rejects negative names
+    if((size_t) (unsigned int) notificationName < this->denseCommands.size())
+        return this->denseCommands[notificationName];
+    if(this->commandMap.empty())
+        return (ICommandFactory*) 0;
+
+    std::map<int, ICommandFactory*>::iterator it = this->commandMap.find(notificationName);
+    if(it == this->commandMap.end())
+        return (ICommandFactory*) 0;
+    return it->second;
+}
+void Controller::deleteRetiredFactories()
+{
+    // pool threads never touch the list, they only count down
+    if(__atomic_load_n(&this->executingInPool, __ATOMIC_ACQUIRE) != 0)
+        return;
+    for(size_t i = 0; i < this->retiredFactories.size(); i++)
+        delete this->retiredFactories[i];
+    this->retiredFactories.clear();
+}
+void Controller::removeController( std::string key )
+{
+    Multiton<Controller>::erase(key);
+}
+void Controller::initializeController( )
+{
+    this->view = View::getInstance(this->getMultitonKey());
+}
+//--------------------------------------
+//  THREAD POOL
+//--------------------------------------
+// the worker running on this thread, if any
+static __thread void* currentWorker = 0;
+static ThreadPool* sharedThreadPool = (ThreadPool*) 0;
+static pthread_once_t sharedThreadPoolOnce = PTHREAD_ONCE_INIT;
+static void createSharedThreadPool()
+{
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    sharedThreadPool = new ThreadPool(processors > 0 ? (unsigned int) processors : 1);
+}
+ThreadPool::ThreadPool( unsigned int threads )
+{
+    pthread_cond_init(&this->available, (pthread_condattr_t*) 0);
+    pthread_cond_init(&this->idle, (pthread_condattr_t*) 0);
+    this->queued = 0;
+    this->pending = 0;
+    this->next = 0;
+    this->stopping = false;
+    if(threads == 0)
+        threads = 1;
+    // every worker exists before any of them starts stealing
+    for(unsigned int i = 0; i < threads; i++)
+    {
+        Worker* worker = new Worker();
+        worker->pool = this;
+        worker->index = i;
+        this->workers.push_back(worker);
+    }
+    for(unsigned int i = 0; i < threads; i++)
+        pthread_create(&this->workers[i]->thread, (pthread_attr_t*) 0, &ThreadPool::work, this->workers[i]);
+}
+ThreadPool::~ThreadPool()
+{
+    this->wait();
+    {
+        ScopedLock lock(this->mutex);
+        this->stopping = true;
+        pthread_cond_broadcast(&this->available);
+    }
+    // the others may still look in a worker's deque until they've all stopped
+    for(size_t i = 0; i < this->workers.size(); i++)
+        pthread_join(this->workers[i]->thread, (void**) 0);
+    for(size_t i = 0; i < this->workers.size(); i++)
+        delete this->workers[i];
+    pthread_cond_destroy(&this->available);
+    pthread_cond_destroy(&this->idle);
+}
+ThreadPool* ThreadPool::shared()
+{
+    pthread_once(&sharedThreadPoolOnce, &createSharedThreadPool);
+    return sharedThreadPool;
+}
+void ThreadPool::submit( Task* task )
+{
+    __atomic_add_fetch(&this->pending, 1, __ATOMIC_ACQ_REL);
+    Worker* worker = (Worker*) currentWorker;
+    if(worker == (Worker*) 0 || worker->pool != this)
+        worker = this->workers[__atomic_fetch_add(&this->next, 1, __ATOMIC_RELAXED) % this->workers.size()];
+    {
+        ScopedLock lock(worker->mutex);
+        worker->tasks.push_back(task);
+    }
+    ScopedLock lock(this->mutex);
+    this->queued++;
+    pthread_cond_signal(&this->available);
+}
+void ThreadPool::wait()
+{
+    ScopedLock lock(this->mutex);
+    while(__atomic_load_n(&this->pending, __ATOMIC_ACQUIRE) != 0)
+        pthread_cond_wait(&this->idle, this->mutex.native());
+}
+unsigned int ThreadPool::size()
+{
+    return (unsigned int) this->workers.size();
+}
+void* ThreadPool::work( void* argument )
+{
+    Worker* worker = (Worker*) argument;
+    ThreadPool* pool = worker->pool;
+    currentWorker = worker;
+    for(;;)
+    {
+        Task* task = pool->take(worker);
+        if(task != (Task*) 0)
+        {
+            task->run();
+            delete task;
+            pool->finish();
+            continue;
+        }
+        ScopedLock lock(pool->mutex);
+        while(pool->queued <= 0 && ! pool->stopping)
+            pthread_cond_wait(&pool->available, pool->mutex.native());
+        if(pool->stopping)
+            return 0;
+    }
+}
+ThreadPool::Task* ThreadPool::take( Worker* worker )
+{
+    Task* task = (Task*) 0;
+    {
+        // newest of our own first, it's likely still in cache
+        ScopedLock lock(worker->mutex);
+        if(! worker->tasks.empty())
+        {
+            task = worker->tasks.back();
+            worker->tasks.pop_back();
+        }
+    }
+    // then the oldest of somebody else's
+    for(size_t i = 1; task == (Task*) 0 && i < this->workers.size(); i++)
+    {
+        Worker* victim = this->workers[(worker->index + i) % this->workers.size()];
+        ScopedLock lock(victim->mutex);
+        if(! victim->tasks.empty())
+        {
+            task = victim->tasks.front();
+            victim->tasks.pop_front();
+        }
+    }
+    if(task != (Task*) 0)
+    {
+        ScopedLock lock(this->mutex);
+        this->queued--;
+    }
+    return task;
+}
+void ThreadPool::finish()
+{
+    if(__atomic_sub_fetch(&this->pending, 1, __ATOMIC_ACQ_REL) != 0)
+        return;
+    ScopedLock lock(this->mutex);
+    pthread_cond_broadcast(&this->idle);
+}
+//--------------------------------------
+//  NOTIFICATION POOL
+//--------------------------------------
+// a notification that knows whose free list it belongs on
+class NotificationPool::Pooled : public Notification
+{
+public:
+    Pooled(Cache* owner) : Notification(0)
+    {
+        this->owner = owner;
+        this->next = (Pooled*) 0;
+    }
+    Cache* owner;
+    Pooled* next;
+};
+// one per thread, only returns may be touched by other threads
+struct NotificationPool::Cache
+{
+    Cache() : free((Pooled*) 0), cached(0), outstanding(0), highWater(0), returned((Pooled*) 0) {}
+    Pooled* free;
+    // read by statistics() from other threads, so stored atomically
+    unsigned long cached;
+    unsigned long outstanding;
+    unsigned long highWater;
+    // released by other threads, pushed lock-free and taken all at once
+    Pooled* returned;
+};
+// the cache of this thread, if it has one
+static __thread void* currentNotificationCache = 0;
+static pthread_key_t notificationCacheKey;
+static pthread_once_t notificationCacheKeyOnce = PTHREAD_ONCE_INIT;
+static unsigned long notificationsCreated = 0;
+std::vector<NotificationPool::Cache*>& NotificationPool::caches()
+{
+    static std::vector<Cache*> caches;
+    return caches;
+}
+std::vector<NotificationPool::Cache*>& NotificationPool::orphans()
+{
+    static std::vector<Cache*> orphans;
+    return orphans;
+}
+Mutex& NotificationPool::mutex()
+{
+    static Mutex mutex;
+    return mutex;
+}
+void NotificationPool::createKey()
+{
+    pthread_key_create(&notificationCacheKey, &NotificationPool::orphan);
+}
+NotificationPool::Cache* NotificationPool::cache()
+{
+    Cache* cache = (Cache*) currentNotificationCache;
+    if(cache != (Cache*) 0)
+        return cache;
+    pthread_once(&notificationCacheKeyOnce, &NotificationPool::createKey);
+    {
+        // a new thread takes over the cache of one that has gone
+        ScopedLock lock(NotificationPool::mutex());
+        std::vector<Cache*>& orphans = NotificationPool::orphans();
+        if(! orphans.empty())
+        {
+            cache = orphans.back();
+            orphans.pop_back();
+        }
+        else
+        {
+            cache = new Cache();
+            NotificationPool::caches().push_back(cache);
+        }
+    }
+    currentNotificationCache = cache;
+    // the key only exists to hear about the thread exiting
+    pthread_setspecific(notificationCacheKey, cache);
+    return cache;
+}
+void NotificationPool::orphan( void* cache )
+{
+    currentNotificationCache = 0;
+    ScopedLock lock(NotificationPool::mutex());
+    NotificationPool::orphans().push_back((Cache*) cache);
+}
+Notification* NotificationPool::acquire( int notificationName, void* body, int notificationType )
+{
+    Cache* cache = NotificationPool::cache();
+    if(cache->free == (Pooled*) 0 && __atomic_load_n(&cache->returned, __ATOMIC_RELAXED) != (Pooled*) 0)
+    {
+        // collect what other threads have handed back
+        Pooled* returned = __atomic_exchange_n(&cache->returned, (Pooled*) 0, __ATOMIC_ACQUIRE);
+        unsigned long count = 0;
+        for(Pooled* pooled = returned; pooled != (Pooled*) 0; pooled = pooled->next)
+            count++;
+        cache->free = returned;
+        __atomic_store_n(&cache->cached, cache->cached + count, __ATOMIC_RELAXED);
+        cache->outstanding -= count;
+    }
+    Pooled* pooled = cache->free;
+    if(pooled != (Pooled*) 0)
+    {
+        cache->free = pooled->next;
+        __atomic_store_n(&cache->cached, cache->cached - 1, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        pooled = new Pooled(cache);
+        __atomic_add_fetch(&notificationsCreated, 1, __ATOMIC_RELAXED);
+    }
+    cache->outstanding++;
+    if(cache->outstanding > cache->highWater)
+        __atomic_store_n(&cache->highWater, cache->outstanding, __ATOMIC_RELAXED);
+    pooled->name = notificationName;
+    pooled->body = body;
+    pooled->type = notificationType;
+    return pooled;
+}
+void NotificationPool::release( Notification* notification )
+{
+    Pooled* pooled = static_cast<Pooled*>(notification);
+    pooled->setBody((void*) 0);
+    Cache* owner = pooled->owner;
+    if(owner != (Cache*) currentNotificationCache)
+    {
+        pooled->next = __atomic_load_n(&owner->returned, __ATOMIC_RELAXED);
+        while(! __atomic_compare_exchange_n(&owner->returned, &pooled->next, pooled, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            ;
+        return;
+    }
+    owner->outstanding--;
+    if(owner->cached >= NotificationPool::MAX_CACHED)
+    {
+        delete pooled;
+        return;
+    }
+    pooled->next = owner->free;
+    owner->free = pooled;
+    __atomic_store_n(&owner->cached, owner->cached + 1, __ATOMIC_RELAXED);
+}
+NotificationPool::Statistics NotificationPool::statistics()
+{
+    Statistics statistics;
+    statistics.created = __atomic_load_n(&notificationsCreated, __ATOMIC_RELAXED);
+    statistics.cached = 0;
+    statistics.highWater = 0;
+    ScopedLock lock(NotificationPool::mutex());
+    std::vector<Cache*>& caches = NotificationPool::caches();
+    statistics.threads = (unsigned int) caches.size();
+    for(size_t i = 0; i < caches.size(); i++)
+    {
+        statistics.cached += __atomic_load_n(&caches[i]->cached, __ATOMIC_RELAXED);
+        unsigned long highWater = __atomic_load_n(&caches[i]->highWater, __ATOMIC_RELAXED);
+        if(highWater > statistics.highWater)
+            statistics.highWater = highWater;
+    }
+    return statistics;
+}
+//--------------------------------------
+//  NOTIFICATION QUEUE
+//--------------------------------------
+NotificationQueue::NotificationQueue()
+{
+    pthread_cond_init(&this->posted, (pthread_condattr_t*) 0);
+    this->woken = false;
+}
+NotificationQueue::~NotificationQueue()
+{
+    for(size_t i = 0; i < this->notifications.size(); i++)
+        NotificationPool::release(this->notifications[i]);
+    pthread_cond_destroy(&this->posted);
+}
+void NotificationQueue::push( Notification* notification )
+{
+    Notification* replaced = (Notification*) 0;
+    {
+        ScopedLock lock(this->mutex);
+        CoalescingKey key;
+        if(this->coalescingKey(notification, key))
+        {
+            std::map<CoalescingKey, Notification**>::iterator queued = this->pending.find(key);
+            if(queued != this->pending.end())
+            {
+                // take the place of the one already waiting
+                replaced = *queued->second;
+                *queued->second = notification;
+            }
+            else
+            {
+                this->notifications.push_back(notification);
+                this->pending[key] = &this->notifications.back();
+            }
+        }
+        else
+            this->notifications.push_back(notification);
+        if(replaced == (Notification*) 0)
+            pthread_cond_signal(&this->posted);
+    }
+    // its payload is destroyed outside the lock
+    if(replaced != (Notification*) 0)
+        NotificationPool::release(replaced);
+}
+Notification* NotificationQueue::pop()
+{
+    ScopedLock lock(this->mutex);
+    if(this->notifications.empty())
+        return (Notification*) 0;
+    Notification* notification = this->notifications.front();
+    CoalescingKey key;
+    if(this->coalescingKey(notification, key))
+    {
+        // unless the mode has changed since, this is the one pending
+        std::map<CoalescingKey, Notification**>::iterator queued = this->pending.find(key);
+        if(queued != this->pending.end() && queued->second == &this->notifications.front())
+            this->pending.erase(queued);
+    }
+    this->notifications.pop_front();
+    return notification;
+}
+bool NotificationQueue::coalescingKey( Notification* notification, CoalescingKey& key )
+{
+    if(this->coalescing.empty())
+        return false;
+    std::map<int, int>::iterator mode = this->coalescing.find(notification->name);
+    if(mode == this->coalescing.end())
+        return false;
+    key.first = notification->name;
+    key.second = mode->second == Coalescing::BY_NAME_AND_TYPE ? notification->type : 0;
+    return true;
+}
+size_t NotificationQueue::size()
+{
+    ScopedLock lock(this->mutex);
+    return this->notifications.size();
+}
+void NotificationQueue::wait()
+{
+    ScopedLock lock(this->mutex);
+    while(this->notifications.empty() && !this->woken)
+        pthread_cond_wait(&this->posted, this->mutex.native());
+    this->woken = false;
+}
+void NotificationQueue::wait( unsigned long milliseconds )
+{
+    // condition variables time out against the wall clock
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += milliseconds / 1000;
+    deadline.tv_nsec += (long) (milliseconds % 1000) * 1000000;
+    if(deadline.tv_nsec >= 1000000000)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+    ScopedLock lock(this->mutex);
+    while(this->notifications.empty() && !this->woken)
+    {
+        if(pthread_cond_timedwait(&this->posted, this->mutex.native(), &deadline) != 0)
+            break;
+    }
+    this->woken = false;
+}
+void NotificationQueue::wake()
+{
+    ScopedLock lock(this->mutex);
+    this->woken = true;
+    pthread_cond_broadcast(&this->posted);
+}
+void NotificationQueue::setCoalescing( int notificationName, int mode )
+{
+    ScopedLock lock(this->mutex);
+    // forget what is waiting, the keys may no longer match
+    std::map<CoalescingKey, Notification**>::iterator queued = this->pending.begin();
+    while(queued != this->pending.end())
+    {
+        if(queued->first.first == notificationName)
+            this->pending.erase(queued++);
+        else
+            ++queued;
+    }
+    if(mode == Coalescing::NONE)
+        this->coalescing.erase(notificationName);
+    else
+        this->coalescing[notificationName] = mode;
+}
+//--------------------------------------
+//  NOTIFICATION RING
+//--------------------------------------
+// its address tells one thread from another
+static __thread char threadMark = 0;
+NotificationRing::NotificationRing( size_t capacity, int policy )
+{
+    size_t size = 2;
+    while(size < capacity)
+        size <<= 1;
+    this->cells = new Cell[size];
+    for(size_t i = 0; i < size; i++)
+    {
+        this->cells[i].sequence = i;
+        this->cells[i].notification = (Notification*) 0;
+    }
+    this->mask = size - 1;
+    this->policy = policy;
+    this->enqueued = 0;
+    this->dequeued = 0;
+    this->consumer = (void*) 0;
+    this->sleeping = 0;
+    this->highWater = 0;
+    this->dropped = 0;
+    this->rejected = 0;
+    this->parked = 0;
+    pthread_cond_init(&this->room, (pthread_condattr_t*) 0);
+}
+NotificationRing::~NotificationRing()
+{
+    Notification* notification;
+    while((notification = this->pop()) != (Notification*) 0)
+        NotificationPool::release(notification);
+    delete [] this->cells;
+    pthread_cond_destroy(&this->room);
+}
+// how many times a blocked producer yields before it sleeps
+static const int BLOCKED_SPINS = 16;
+bool NotificationRing::push( Notification* notification )
+{
+    int spins = 0;
+    while(! this->tryPush(notification))
+    {
+        // the consumer can't wait for itself to make room
+        if(this->policy == Backpressure::FAIL
+            || (this->policy == Backpressure::BLOCK && __atomic_load_n(&this->consumer, __ATOMIC_RELAXED) == (void*) &threadMark))
+        {
+            __atomic_add_fetch(&this->rejected, 1, __ATOMIC_RELAXED);
+            return false;
+        }
+        if(this->policy == Backpressure::DROP_OLDEST)
+        {
+            // the consumer may beat us to it, either way there's room now
+            Notification* oldest = this->pop();
+            if(oldest != (Notification*) 0)
+            {
+                NotificationPool::release(oldest);
+                __atomic_add_fetch(&this->dropped, 1, __ATOMIC_RELAXED);
+            }
+        }
+        else if(spins++ < BLOCKED_SPINS)
+            sched_yield();
+        else
+        {
+            this->waitForRoom(notification);
+            break;
+        }
+    }
+    size_t depth = this->size();
+    size_t highWater = __atomic_load_n(&this->highWater, __ATOMIC_RELAXED);
+    while(depth > highWater && ! __atomic_compare_exchange_n(&this->highWater, &highWater, depth, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+    return true;
+}
+void NotificationRing::waitForRoom( Notification* notification )
+{
+    ScopedLock lock(this->roomMutex);
+    __atomic_add_fetch(&this->sleeping, 1, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&this->parked, 1, __ATOMIC_RELAXED);
+    // announced before looking again, so a pop that makes room after
+    // this look sees us and signals
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    while(! this->tryPush(notification))
+        pthread_cond_wait(&this->room, this->roomMutex.native());
+    __atomic_sub_fetch(&this->sleeping, 1, __ATOMIC_RELAXED);
+}
+bool NotificationRing::tryPush( Notification* notification )
+{
+    size_t position = __atomic_load_n(&this->enqueued, __ATOMIC_RELAXED);
+    for(;;)
+    {
+        Cell* cell = &this->cells[position & this->mask];
+        size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        intptr_t turn = (intptr_t) sequence - (intptr_t) position;
+        if(turn == 0)
+        {
+            // the cell is free for this position, claim it
+            if(__atomic_compare_exchange_n(&this->enqueued, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                cell->notification = notification;
+                __atomic_store_n(&cell->sequence, position + 1, __ATOMIC_SEQ_CST);
+                return true;
+            }
+        }
+        else if(turn < 0)
+            // still holding a notification from a lap ago, we're full
+            return false;
+        else
+            position = __atomic_load_n(&this->enqueued, __ATOMIC_RELAXED);
+    }
+}
+Notification* NotificationRing::pop()
+{
+    size_t position = __atomic_load_n(&this->dequeued, __ATOMIC_RELAXED);
+    for(;;)
+    {
+        Cell* cell = &this->cells[position & this->mask];
+        size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        intptr_t turn = (intptr_t) sequence - (intptr_t) (position + 1);
+        if(turn == 0)
+        {
+            if(__atomic_compare_exchange_n(&this->dequeued, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                Notification* notification = cell->notification;
+                // free for the producer one lap on
+                if(this->policy != Backpressure::BLOCK)
+                    __atomic_store_n(&cell->sequence, position + this->mask + 1, __ATOMIC_RELEASE);
+                else
+                {
+                    // ordered before reading sleeping, against waitForRoom
+                    __atomic_store_n(&cell->sequence, position + this->mask + 1, __ATOMIC_SEQ_CST);
+                    if(__atomic_load_n(&this->sleeping, __ATOMIC_SEQ_CST) != 0)
+                    {
+                        ScopedLock lock(this->roomMutex);
+                        pthread_cond_signal(&this->room);
+                    }
+                }
+                return notification;
+            }
+        }
+        else if(turn < 0)
+            return (Notification*) 0;
+        else
+            position = __atomic_load_n(&this->dequeued, __ATOMIC_RELAXED);
+    }
+}
+void NotificationRing::bindConsumer()
+{
+    if(__atomic_load_n(&this->consumer, __ATOMIC_RELAXED) != (void*) &threadMark)
+        __atomic_store_n(&this->consumer, (void*) &threadMark, __ATOMIC_RELAXED);
+}
+size_t NotificationRing::size()
+{
+    size_t dequeued = __atomic_load_n(&this->dequeued, __ATOMIC_RELAXED);
+    size_t enqueued = __atomic_load_n(&this->enqueued, __ATOMIC_RELAXED);
+    // claimed positions may not be filled yet, and the two reads race
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+}
+bool NotificationRing::empty()
+{
+    size_t position = __atomic_load_n(&this->dequeued, __ATOMIC_RELAXED);
+    Cell* cell = &this->cells[position & this->mask];
+    return __atomic_load_n(&cell->sequence, __ATOMIC_SEQ_CST) != position + 1;
+}
+NotificationRing::Statistics NotificationRing::statistics()
+{
+    Statistics statistics;
+    statistics.capacity = this->mask + 1;
+    statistics.depth = this->size();
+    statistics.highWater = __atomic_load_n(&this->highWater, __ATOMIC_RELAXED);
+    statistics.dropped = __atomic_load_n(&this->dropped, __ATOMIC_RELAXED);
+    statistics.rejected = __atomic_load_n(&this->rejected, __ATOMIC_RELAXED);
+    statistics.parked = __atomic_load_n(&this->parked, __ATOMIC_RELAXED);
+    return statistics;
+}
+//--------------------------------------
+//  TIMER WHEEL
+//--------------------------------------
+TimerWheel::TimerWheel( uint64_t start )
+{
+    for(unsigned int i = 0; i < LEVELS * SLOTS; i++)
+        this->buckets[i] = -1;
+    for(unsigned int level = 0; level < LEVELS; level++)
+        this->occupied[level] = 0;
+    this->current = start;
+    this->sleepingUntil = ~(uint64_t) 0;
+    this->scheduled = 0;
+}
+uint64_t TimerWheel::now()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t) time.tv_sec * 1000 + (uint64_t) time.tv_nsec / 1000000;
+}
+Timer TimerWheel::schedule( uint64_t now, unsigned long delay, unsigned long period, int notificationName, void* body, int notificationType, bool& sooner )
+{
+    ScopedLock lock(this->mutex);
+    // an empty wheel isn't advanced, catch it up first
+    if(this->scheduled == 0 && now > this->current)
+        this->current = now;
+    uint64_t expires = now + delay;
+    int index;
+    if(! this->freeNodes.empty())
+    {
+        index = this->freeNodes.back();
+        this->freeNodes.pop_back();
+    }
+    else
+    {
+        Node fresh;
+        fresh.generation = 1;
+        fresh.bucket = -1;
+        index = (int) this->nodes.size();
+        this->nodes.push_back(fresh);
+    }
+    Node& node = this->nodes[index];
+    // what is due now goes out on the next tick
+    node.expires = expires > this->current ? expires : this->current + 1;
+    node.period = period;
+    node.notificationName = notificationName;
+    node.body = body;
+    node.notificationType = notificationType;
+    this->insert(index);
+    __atomic_store_n(&this->scheduled, this->scheduled + 1, __ATOMIC_RELAXED);
+
+    sooner = node.expires < this->sleepingUntil;
+    if(sooner)
+        this->sleepingUntil = node.expires;
+    return Timer((unsigned int) index, node.generation);
+}
+bool TimerWheel::cancel( Timer timer )
+{
+    ScopedLock lock(this->mutex);
+    if(timer.index >= this->nodes.size())
+        return false;
+    Node& node = this->nodes[timer.index];
+    if(node.generation != timer.generation || node.bucket < 0)
+        return false;
+    this->unlink((int) timer.index);
+    if(++node.generation == 0)
+        node.generation = 1;
+    this->freeNodes.push_back((int) timer.index);
+    __atomic_store_n(&this->scheduled, this->scheduled - 1, __ATOMIC_RELAXED);
+    return true;
+}
+unsigned int TimerWheel::advance( uint64_t now, NotificationQueue& queue )
+{
+    ScopedLock lock(this->mutex);
+    unsigned int posted = 0;
+    while(this->current < now)
+    {
+        if(this->scheduled == 0)
+        {
+            this->current = now;
+            break;
+        }
+        // nothing happens until a turn of the lowest occupied level
+        for(unsigned int level = 0; level < LEVELS - 1 && this->occupied[level] == 0; level++)
+        {
+            uint64_t turn = ((this->current >> (SLOT_BITS * (level + 1))) + 1) << (SLOT_BITS * (level + 1));
+            if(turn - 1 > this->current)
+                this->current = turn - 1 < now ? turn - 1 : now;
+        }
+        if(this->current >= now)
+            break;
+        this->current++;
+        // entering a new turn of a level brings its next slot down a level
+        for(unsigned int level = 1; level < LEVELS; level++)
+        {
+            if(((this->current >> (SLOT_BITS * (level - 1))) & (SLOTS - 1)) != 0)
+                break;
+            unsigned int slot = (unsigned int) (this->current >> (SLOT_BITS * level)) & (SLOTS - 1);
+            int index = this->detach(level * SLOTS + slot);
+            while(index >= 0)
+            {
+                int next = this->nodes[index].next;
+                this->insert(index);
+                index = next;
+            }
+        }
+        int index = this->detach((int) (this->current & (SLOTS - 1)));
+        while(index >= 0)
+        {
+            Node& node = this->nodes[index];
+            int next = node.next;
+            queue.push(NotificationPool::acquire(node.notificationName, node.body, node.notificationType));
+            posted++;
+            if(node.period != 0)
+            {
+                node.expires = this->current + node.period;
+                this->insert(index);
+            }
+            else
+            {
+                if(++node.generation == 0)
+                    node.generation = 1;
+                this->freeNodes.push_back(index);
+                __atomic_store_n(&this->scheduled, this->scheduled - 1, __ATOMIC_RELAXED);
+            }
+            index = next;
+        }
+    }
+    return posted;
+}
+bool TimerWheel::nextExpiry( uint64_t& expiry )
+{
+    ScopedLock lock(this->mutex);
+    this->sleepingUntil = ~(uint64_t) 0;
+    if(this->scheduled == 0)
+        return false;
+    // the first occupied slot ahead on each level bounds that level's timers
+    for(unsigned int level = 0; level < LEVELS; level++)
+    {
+        uint64_t turn = this->current >> (SLOT_BITS * level);
+        for(uint64_t ahead = 1; ahead <= SLOTS; ahead++)
+        {
+            if(this->buckets[level * SLOTS + ((turn + ahead) & (SLOTS - 1))] < 0)
+                continue;
+            uint64_t start = (turn + ahead) << (SLOT_BITS * level);
+            if(start < this->sleepingUntil)
+                this->sleepingUntil = start;
+            break;
+        }
+    }
+    expiry = this->sleepingUntil;
+    return true;
+}
+size_t TimerWheel::size()
+{
+    return __atomic_load_n(&this->scheduled, __ATOMIC_RELAXED);
+}
+void TimerWheel::insert( int index )
+{
+    Node& node = this->nodes[index];
+    uint64_t delta = node.expires - this->current;
+    unsigned int level = 0;
+    while(level < LEVELS - 1 && delta >> (SLOT_BITS * (level + 1)) != 0)
+        level++;
+    if(delta >> (SLOT_BITS * LEVELS) != 0)
+        node.expires = this->current + (((uint64_t) 1 << (SLOT_BITS * LEVELS)) - 1);
+    int bucket = (int) (level * SLOTS + ((node.expires >> (SLOT_BITS * level)) & (SLOTS - 1)));
+    node.bucket = bucket;
+    this->occupied[level]++;
+    node.previous = -1;
+    node.next = this->buckets[bucket];
+    if(node.next >= 0)
+        this->nodes[node.next].previous = index;
+    this->buckets[bucket] = index;
+}
+void TimerWheel::unlink( int index )
+{
+    Node& node = this->nodes[index];
+    if(node.previous >= 0)
+        this->nodes[node.previous].next = node.next;
+    else
+        this->buckets[node.bucket] = node.next;
+    if(node.next >= 0)
+        this->nodes[node.next].previous = node.previous;
+    this->occupied[node.bucket / SLOTS]--;
+    node.bucket = -1;
+}
+int TimerWheel::detach( int bucket )
+{
+    int first = this->buckets[bucket];
+    this->buckets[bucket] = -1;
+    for(int index = first; index >= 0; index = this->nodes[index].next)
+    {
+        this->nodes[index].bucket = -1;
+        this->occupied[bucket / SLOTS]--;
+    }
+    return first;
+}
+//--------------------------------------
+//  FACADE
+//--------------------------------------
+unsigned long Facade::coreGeneration = 0;
+// marks a RUN_TO_COMPLETION delivery, cleared even if a handler throws
+class DispatchGuard
+{
+public:
+    DispatchGuard(bool& dispatching) : dispatching(dispatching)
+    {
+        this->dispatching = true;
+    }
+    ~DispatchGuard()
+    {
+        this->dispatching = false;
+    }
+private:
+    DispatchGuard(DispatchGuard const&);
+    DispatchGuard& operator=(DispatchGuard const&);
+    bool& dispatching;
+};
+// returns a deferred notification to its pool once it has been delivered
+class PooledRelease
+{
+public:
+    PooledRelease(Notification* notification) : notification(notification) {}
+    ~PooledRelease()
+    {
+        NotificationPool::release(this->notification);
+    }
+private:
+    PooledRelease(PooledRelease const&);
+    PooledRelease& operator=(PooledRelease const&);
+    Notification* notification;
+};
+
+Facade::Facade() : timers(TimerWheel::now())
+{
+    this->inbox = new NotificationRing(1024, Backpressure::BLOCK);
+    this->sleeping = 0;
+    this->dispatchMode = DispatchMode::RECURSIVE;
+    this->dispatching = false;
+	this->model = (IModel*) 0;
+	this->view = (IView*) 0;
 	this->controller = (IController*) 0;
+	this->looping = false;
+    this->initialized = false;
 }
 Facade* Facade::getInstance(std::string key)
 {
-    Facade* facade = Multiton<Facade>::instance(key);
+    // if the instance exists and is initialized, return it
+    CoreId id = MultitonKey::intern(key);
+    Facade* facade = Facade::find(id);
+    if(facade != (Facade*) 0)
+        return facade;
+    ScopedLock lock(coreCreationMutex());
+    // a notifier may have made it without initializing it
+    facade = Multiton<Facade>::instance(id);
+    if(facade->initialized)
+        return facade;
     facade->initializeNotifier(key);
     facade->initializeFacade();
+    __atomic_store_n(&facade->initialized, true, __ATOMIC_RELEASE);
+    return facade;
+}
+Facade* Facade::find( CoreId id )
+{
+    Facade* facade = Multiton<Facade>::find(id);
+    if(facade == (Facade*) 0 || ! __atomic_load_n(&facade->initialized, __ATOMIC_ACQUIRE))
+        return (Facade*) 0;
     return facade;
 }
 void Facade::initializeNotifier(std::string key)
@@ -477,15 +2390,23 @@ void Facade::registerProxy( IProxy* proxy )
 {
     this->model->registerProxy(proxy);
 }
-IProxy* Facade::retrieveProxy( std::string proxyName )
+void Facade::registerProxyFactory( std::string proxyName, IProxyFactory* factory )
+{
+    this->model->registerProxyFactory(proxyName, factory);
+}
+void Facade::registerProxies( const std::vector<ProxyRegistration>& registrations )
+{
+    this->model->registerProxies(registrations);
+}
+IProxy* Facade::retrieveProxy( StringRef proxyName )
 {
     return this->model->retrieveProxy(proxyName);
 }
-IProxy* Facade::removeProxy ( std::string proxyName )
+IProxy* Facade::removeProxy ( StringRef proxyName )
 {
     return this->model->removeProxy(proxyName);
 }
-bool Facade::hasProxy( std::string proxyName )
+bool Facade::hasProxy( StringRef proxyName )
 {
     return this->model->hasProxy(proxyName);
 }
@@ -509,25 +2430,248 @@ bool Facade::hasMediator( std::string mediatorName )
 }
 void Facade::sendNotification( int notificationName, void* body, int notificationType)
 {
-    this->notifyObservers(new Notification(notificationName, body, notificationType));
+    // observers only borrow the notification for the duration of the
+    // call, so it can live on our stack
+    Notification notification(notificationName, body, notificationType);
+    this->notifyObservers(&notification);
 }
 void Facade::sendNotification( int notificationName, int notificationType )
 {
-    this->notifyObservers(new Notification(notificationName, notificationType));
+    Notification notification(notificationName, notificationType);
+    this->notifyObservers(&notification);
 }
 void Facade::sendNotification( int notificationName, void* body )
 {
-    this->notifyObservers(new Notification(notificationName, body));
+    Notification notification(notificationName, body);
+    this->notifyObservers(&notification);
 }
 void Facade::sendNotification( int notificationName )
 {
-    this->notifyObservers(new Notification(notificationName));
+    Notification notification(notificationName);
+    this->notifyObservers(&notification);
+}
+void Facade::sendNotifications( int notificationName, void* const* bodies, size_t count, int notificationType )
+{
+    if(this->view == (IView*) 0)
+        return;
+    if(this->dispatching)
+    {
+        // the batch falls apart into its notifications
+        for(size_t i = 0; i < count; i++)
+            this->deferred.push_back(NotificationPool::acquire(notificationName, bodies[i], notificationType));
+        return;
+    }
+    if(this->dispatchMode == DispatchMode::RECURSIVE)
+    {
+        this->view->notifyObserversBatch(notificationName, bodies, count, notificationType);
+        return;
+    }
+    DispatchGuard guard(this->dispatching);
+    this->view->notifyObserversBatch(notificationName, bodies, count, notificationType);
+    this->deliverDeferred();
+}
+void Facade::sendNotifications( int notificationName, void* const* bodies, size_t count )
+{
+    this->sendNotifications(notificationName, bodies, count, 0);
+}
+void Facade::unsubscribe( Subscription subscription )
+{
+    this->view->removeObserver(subscription);
+}
+void Facade::postNotification( int notificationName, void* body, int notificationType)
+{
+    this->queue.push(NotificationPool::acquire(notificationName, body, notificationType));
+}
+void Facade::postNotification( int notificationName, int notificationType )
+{
+    this->queue.push(NotificationPool::acquire(notificationName, (void*) 0, notificationType));
+}
+void Facade::postNotification( int notificationName, void* body )
+{
+    this->queue.push(NotificationPool::acquire(notificationName, body, 0));
+}
+void Facade::postNotification( int notificationName )
+{
+    this->queue.push(NotificationPool::acquire(notificationName, (void*) 0, 0));
+}
+void Facade::postNotification( int notificationName, Payload& payload, int notificationType )
+{
+    Notification* notification = NotificationPool::acquire(notificationName, (void*) 0, notificationType);
+    notification->takePayload(payload);
+    this->queue.push(notification);
+}
+void Facade::postNotification( int notificationName, Payload& payload )
+{
+    this->postNotification(notificationName, payload, 0);
+}
+unsigned int Facade::pump()
+{
+    if(this->timers.size() != 0)
+        this->timers.advance(TimerWheel::now(), this->queue);
+    // only deliver what was queued on entry, anything posted by the
+    // observers waits for the next pump
+    size_t pending = this->queue.size();
+    this->inbox->bindConsumer();
+    size_t inboxPending = this->inbox->size();
+    unsigned int delivered = 0;
+    Notification* notification;
+    while(delivered < pending && (notification = this->queue.pop()) != (Notification*) 0)
+    {
+        this->notifyObservers(notification);
+        // takes the payload with it
+        NotificationPool::release(notification);
+        delivered++;
+    }
+    for(size_t i = 0; i < inboxPending && (notification = this->inbox->pop()) != (Notification*) 0; i++)
+    {
+        this->notifyObservers(notification);
+        NotificationPool::release(notification);
+        delivered++;
+    }
+    return delivered;
+}
+void Facade::runEventLoop()
+{
+    __atomic_store_n(&this->looping, true, __ATOMIC_RELEASE);
+    while(__atomic_load_n(&this->looping, __ATOMIC_ACQUIRE))
+    {
+        if(this->pump() != 0)
+            continue;
+        // sleep until something is posted or the next timer is due
+        uint64_t expiry;
+        if(! this->timers.nextExpiry(expiry))
+            this->sleep(0);
+        else
+        {
+            uint64_t now = TimerWheel::now();
+            if(expiry > now)
+                this->sleep((unsigned long) (expiry - now));
+        }
+    }
+}
+void Facade::sleep( unsigned long milliseconds )
+{
+    // inbox producers don't touch the queue's lock, so tell them we're
+    // asleep before looking in the inbox one last time
+    __atomic_store_n(&this->sleeping, 1, __ATOMIC_SEQ_CST);
+    if(this->inbox->empty())
+    {
+        if(milliseconds == 0)
+            this->queue.wait();
+        else
+            this->queue.wait(milliseconds);
+    }
+    __atomic_store_n(&this->sleeping, 0, __ATOMIC_RELAXED);
+}
+void Facade::stopEventLoop()
+{
+    __atomic_store_n(&this->looping, false, __ATOMIC_RELEASE);
+    this->queue.wake();
+}
+void Facade::setCoalescing( int notificationName, int mode )
+{
+    this->queue.setCoalescing(notificationName, mode);
+}
+Timer Facade::sendNotificationAfter( unsigned long milliseconds, int notificationName, void* body, int notificationType )
+{
+    bool sooner;
+    Timer timer = this->timers.schedule(TimerWheel::now(), milliseconds, 0, notificationName, body, notificationType, sooner);
+    // the event loop may be asleep until a later timer, or for good
+    if(sooner)
+        this->queue.wake();
+    return timer;
+}
+Timer Facade::sendNotificationEvery( unsigned long milliseconds, int notificationName, void* body, int notificationType )
+{
+    if(milliseconds == 0)
+        milliseconds = 1;
+    bool sooner;
+    Timer timer = this->timers.schedule(TimerWheel::now(), milliseconds, milliseconds, notificationName, body, notificationType, sooner);
+    if(sooner)
+        this->queue.wake();
+    return timer;
+}
+bool Facade::cancelTimer( Timer timer )
+{
+    return this->timers.cancel(timer);
+}
+void Facade::setInbox( size_t capacity, int policy )
+{
+    NotificationRing* previous = this->inbox;
+    this->inbox = new NotificationRing(capacity, policy);
+    Notification* notification;
+    while((notification = previous->pop()) != (Notification*) 0)
+        this->inbox->push(notification);
+    delete previous;
+}
+bool Facade::postToInbox( int notificationName, void* body, int notificationType )
+{
+    return this->deliverToInbox(NotificationPool::acquire(notificationName, body, notificationType));
+}
+bool Facade::postToInbox( int notificationName, Payload& payload, int notificationType )
+{
+    Notification* notification = NotificationPool::acquire(notificationName, (void*) 0, notificationType);
+    notification->takePayload(payload);
+    return this->deliverToInbox(notification);
+}
+bool Facade::deliverToInbox( Notification* notification )
+{
+    if(! this->inbox->push(notification))
+    {
+        NotificationPool::release(notification);
+        return false;
+    }
+    // pairs with the loop announcing it's asleep, one of us sees the other
+    if(__atomic_load_n(&this->sleeping, __ATOMIC_SEQ_CST) != 0)
+        this->queue.wake();
+    return true;
+}
+NotificationRing::Statistics Facade::inboxStatistics()
+{
+    return this->inbox->statistics();
 }
 void Facade::notifyObservers ( INotification* notification )
 {
     if(this->view == (IView*) 0)
         return;
+    if(this->dispatchMode == DispatchMode::RECURSIVE)
+    {
+        this->view->notifyObservers(notification);
+        return;
+    }
+    if(this->dispatching)
+    {
+        this->defer(notification);
+        return;
+    }
+    DispatchGuard guard(this->dispatching);
     this->view->notifyObservers(notification);
+    this->deliverDeferred();
+}
+void Facade::setDispatchMode( int mode )
+{
+    this->dispatchMode = mode;
+}
+void Facade::defer( INotification* notification )
+{
+    Notification* copy = NotificationPool::acquire(notification->getName(), notification->getBody(), notification->getType());
+    // the sender's notification is about to go, keep what we can of it
+    Notification* source = dynamic_cast<Notification*>(notification);
+    if(source != (Notification*) 0)
+        source->copyTo(*copy);
+    this->deferred.push_back(copy);
+}
+void Facade::deliverDeferred()
+{
+    // anything these send joins the back of the line, if a handler
+    // throws the rest wait for the next delivery
+    while(! this->deferred.empty())
+    {
+        Notification* notification = this->deferred.front();
+        this->deferred.pop_front();
+        PooledRelease release(notification);
+        this->view->notifyObservers(notification);
+    }
 }
 bool Facade::hasCore( std::string key )
 {
@@ -535,6 +2679,7 @@ bool Facade::hasCore( std::string key )
 }
 void Facade::removeCore( std::string key )
 {
+    ScopedLock lock(coreCreationMutex());
     if(! Facade::hasCore(key))
         return;
 
@@ -542,4 +2687,10 @@ void Facade::removeCore( std::string key )
     View::removeView(key);
     Controller::removeController(key);
     Multiton<Facade>::erase(key);
+    // drop every Notifier's cached facade
+    __atomic_add_fetch(&Facade::coreGeneration, 1, __ATOMIC_RELEASE);
+}
+unsigned long Facade::getCoreGeneration()
+{
+    return __atomic_load_n(&Facade::coreGeneration, __ATOMIC_ACQUIRE);
 }
@@ -13,20 +13,176 @@
 
 #include<string>
 #include<vector>
+#include<deque>
 #include<map>
 #include<iostream>
 #include<cstdlib>
+#include<climits>
+#include<cstring>
+#include<new>
 #include<stdint.h>
+#include<pthread.h>
 
 /**
  *  The PureMVC namespace.
  **/
 namespace PureMVC {
+    //--------------------------------------
+    //  Mutex
+    //--------------------------------------
+    /**
+     *  A pthread mutex.
+     */
+    class Mutex
+    {
+    public:
+        /**
+         *  Constructor.
+         *  @param recursive whether the owning thread may lock it again
+         */
+        Mutex(bool recursive = false)
+        {
+            pthread_mutexattr_t attributes;
+            pthread_mutexattr_init(&attributes);
+            if(recursive)
+                pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+            pthread_mutex_init(&this->mutex, &attributes);
+            pthread_mutexattr_destroy(&attributes);
+        }
+        ~Mutex()
+        {
+            pthread_mutex_destroy(&this->mutex);
+        }
+        void lock()
+        {
+            pthread_mutex_lock(&this->mutex);
+        }
+        void unlock()
+        {
+            pthread_mutex_unlock(&this->mutex);
+        }
+        /**
+         *  The underlying pthread mutex, for use with condition variables.
+         */
+        pthread_mutex_t* native()
+        {
+            return &this->mutex;
+        }
+    private:
+        Mutex(Mutex const&);
+        Mutex& operator=(Mutex const&);
+        pthread_mutex_t mutex;
+    };
+    /**
+     *  Locks a mutex for the lifetime of the lock.
+     */
+    class ScopedLock
+    {
+    public:
+        ScopedLock(Mutex& mutex) : mutex(mutex)
+        {
+            this->mutex.lock();
+        }
+        ~ScopedLock()
+        {
+            this->mutex.unlock();
+        }
+    private:
+        ScopedLock(ScopedLock const&);
+        ScopedLock& operator=(ScopedLock const&);
+        Mutex& mutex;
+    };
+    /**
+     *  A string that is looked at but not kept.
+     *  StringRef points at the characters of a <code>std::string</code>
+     *  or a C string without copying them, so a lookup by name does not
+     *  have to allocate. It is only valid as long as the string it was
+     *  made from.
+     */
+    class StringRef
+    {
+    public:
+        StringRef(const std::string& string) : characters(string.data()), length(string.size()) {}
+        StringRef(const char* string) : characters(string), length(strlen(string)) {}
+        const char* data() const
+        {
+            return this->characters;
+        }
+        size_t size() const
+        {
+            return this->length;
+        }
+        std::string str() const
+        {
+            return std::string(this->characters, this->length);
+        }
+        bool operator==(const std::string& string) const
+        {
+            return this->length == string.size() && memcmp(this->characters, string.data(), this->length) == 0;
+        }
+    private:
+        const char* characters;
+        size_t length;
+    };
+    /**
+     *  A handle for an interned multiton key.
+     *  Every distinct multiton key string maps to one small CoreId
+     *  for the life of the process.
+     *  @see MultitonKey
+     */
+    typedef unsigned int CoreId;
+    /**
+     *  Interns multiton keys.
+     *  MultitonKey hands out a compact CoreId for every distinct key
+     *  string, so the Multiton and the core actors can index their
+     *  instances by integer instead of comparing strings.
+     *  All of its methods are thread safe, and <code>lookup</code>,
+     *  or <code>intern</code> of a key seen before, never lock.
+     */
+    class MultitonKey
+    {
+    public:
+        /**
+         *  Intern a key.
+         *  Returns the CoreId of key, assigning a new one the first
+         *  time key is seen.
+         *  @param key A string key
+         */
+        static CoreId intern(const std::string& key);
+        /**
+         *  Look a key up without interning it.
+         *  @param key A string key
+         *  @param id Set to the CoreId of key, if it has one
+         *  @return whether key has been interned
+         */
+        static bool lookup(const std::string& key, CoreId& id);
+        /**
+         *  Get the key string for a CoreId.
+         *  @param id A CoreId returned by intern
+         */
+        static const std::string& name(CoreId id);
+        /**
+         *  The CoreId of the empty key, which is always interned.
+         */
+        static const CoreId EMPTY = 0;
+    private:
+        MultitonKey();
+    };
     /**
      *  A templated Multiton class.
      *  Multiton takes care of creating multitons of other classes.
      *  We use this instead implementing multiton code in Facade,
      *  Model, Controller, etc.
+     *  Instances are kept in a flat array indexed by CoreId; the
+     *  string key overloads intern the key and forward to the
+     *  CoreId overloads.
+     *  <P>
+     *  Multiton is thread safe. Looking up an existing instance by
+     *  CoreId takes no lock: the array is published through an atomic
+     *  pointer and grown by copying, and old arrays are kept around for
+     *  readers that may still hold them. Creating and erasing instances
+     *  takes a short per-T lock. <code>clear</code> must not race with
+     *  readers.</P>
      */
     template <class T>
     class Multiton
@@ -39,32 +195,96 @@ namespace PureMVC {
          */
         static T* instance()
         {
-            std::string key = "key";
-            return Multiton<T>::instance(key);
+            static const CoreId id = MultitonKey::intern("key");
+            return Multiton<T>::instance(id);
         }
         /**
          *  Retrieve a named instance of T.
          *  Create a new named instance of T or return one pointed to by key.
          *  @param key A string key
          */
-        static T* instance(std::string key)
+        static T* instance(const std::string& key)
         {
-            if(Multiton<T>::exists(key))
-                return Multiton<T>::instanceMap[key];
-
-            T* inst = new T();
+            return Multiton<T>::instance(MultitonKey::intern(key));
+        }
+        /**
+         *  Retrieve an instance of T by CoreId.
+         *  Create a new instance of T or return the one stored at id.
+         *  @param id A CoreId from MultitonKey::intern
+         */
+        static T* instance(CoreId id)
+        {
+            T* inst = Multiton<T>::find(id);
+            if(inst != (T*) 0)
+                return inst;
 
-            Multiton<T>::instanceMap[key] = inst;
+            pthread_mutex_lock(&Multiton<T>::mutex);
+            // someone may have beaten us to it
+            inst = Multiton<T>::find(id);
+            if(inst == (T*) 0)
+            {
+                Table* table = Multiton<T>::reserve(id);
+                inst = new T();
+                __atomic_store_n(&table->slots[id], inst, __ATOMIC_RELEASE);
+                __atomic_add_fetch(&Multiton<T>::count, 1, __ATOMIC_RELEASE);
+            }
+            pthread_mutex_unlock(&Multiton<T>::mutex);
             return inst;
         }
+        /**
+         *  Store an instance of T at id, built and set up by the caller.
+         *  Lock-free readers never see the instance before it is stored,
+         *  so they never see it half set up. If one is stored at id
+         *  already, that one is kept and returned instead.
+         *  @param id A CoreId from MultitonKey::intern
+         *  @param inst The instance, owned by the Multiton once stored
+         *  @return the instance stored at id
+         */
+        static T* insert(CoreId id, T* inst)
+        {
+            pthread_mutex_lock(&Multiton<T>::mutex);
+            T* stored = Multiton<T>::find(id);
+            if(stored == (T*) 0)
+            {
+                Table* table = Multiton<T>::reserve(id);
+                __atomic_store_n(&table->slots[id], inst, __ATOMIC_RELEASE);
+                __atomic_add_fetch(&Multiton<T>::count, 1, __ATOMIC_RELEASE);
+                stored = inst;
+            }
+            pthread_mutex_unlock(&Multiton<T>::mutex);
+            return stored;
+        }
+        /**
+         *  Find an instance of T by CoreId.
+         *  Never creates an instance and never locks.
+         *  @param id A CoreId from MultitonKey::intern
+         *  @return the instance stored at id, or a null pointer
+         */
+        static T* find(CoreId id)
+        {
+            Table* table = __atomic_load_n(&Multiton<T>::table, __ATOMIC_ACQUIRE);
+            if(table != (Table*) 0 && id < table->capacity)
+                return __atomic_load_n(&table->slots[id], __ATOMIC_ACQUIRE);
+            return (T*) 0;
+        }
         /**
          *  Check existance.
          *  Check whether or not an instance of name key exists.
          *  @param key A string key
          */
-        static bool exists(std::string key)
+        static bool exists(const std::string& key)
+        {
+            CoreId id;
+            return MultitonKey::lookup(key, id) && Multiton<T>::exists(id);
+        }
+        /**
+         *  Check existance.
+         *  Check whether or not an instance exists at id.
+         *  @param id A CoreId from MultitonKey::intern
+         */
+        static bool exists(CoreId id)
         {
-            return Multiton<T>::instanceMap.find(key) != Multiton<T>::instanceMap.end();
+            return Multiton<T>::find(id) != (T*) 0;
         }
         /**
          *  Total instances.
@@ -72,16 +292,32 @@ namespace PureMVC {
          */
         static size_t size()
         {
-            return Multiton<T>::instanceMap.size();
+            return __atomic_load_n(&Multiton<T>::count, __ATOMIC_ACQUIRE);
         }
         /**
          *  Deletes an instance.
          *  Deletes one instance of key <code>key</code>.
          *
          */
-        static void erase(std::string key)
+        static void erase(const std::string& key)
+        {
+            CoreId id;
+            if(MultitonKey::lookup(key, id))
+                Multiton<T>::erase(id);
+        }
+        /**
+         *  Deletes an instance.
+         *  Deletes the instance stored at id.
+         */
+        static void erase(CoreId id)
         {
-            Multiton<T>::instanceMap.erase(key);
+            pthread_mutex_lock(&Multiton<T>::mutex);
+            if(Multiton<T>::exists(id))
+            {
+                __atomic_store_n(&Multiton<T>::table->slots[id], (T*) 0, __ATOMIC_RELEASE);
+                __atomic_sub_fetch(&Multiton<T>::count, 1, __ATOMIC_RELEASE);
+            }
+            pthread_mutex_unlock(&Multiton<T>::mutex);
         }
         /**
          *  Deletes instances.
@@ -89,18 +325,64 @@ namespace PureMVC {
          */
         static void clear()
         {
-            Multiton<T>::instanceMap.clear();
+            pthread_mutex_lock(&Multiton<T>::mutex);
+            Table* table = Multiton<T>::table;
+            for(size_t i = 0; table != (Table*) 0 && i < table->capacity; i++)
+                __atomic_store_n(&table->slots[i], (T*) 0, __ATOMIC_RELEASE);
+            __atomic_store_n(&Multiton<T>::count, 0, __ATOMIC_RELEASE);
+            pthread_mutex_unlock(&Multiton<T>::mutex);
         }
     private:
         Multiton();
         ~Multiton();
         Multiton(Multiton const&); // copy constructor
         Multiton& operator=(Multiton const&);
-        static std::map<std::string, T*> instanceMap;
+        /**
+         *  A published instance array.
+         *  Never freed: a lock-free reader may still be looking at it.
+         *  Arrays double in size, so the retired ones add up to less
+         *  than the live one.
+         */
+        struct Table
+        {
+            size_t capacity;
+            T** slots;
+            Table* retired;
+        };
+        /**
+         *  Get a table with room for id, growing it if needed.
+         *  Called with the mutex held.
+         */
+        static Table* reserve(CoreId id)
+        {
+            Table* table = Multiton<T>::table;
+            if(table != (Table*) 0 && id < table->capacity)
+                return table;
+
+            size_t capacity = table == (Table*) 0 ? 8 : table->capacity * 2;
+            while(capacity <= id)
+                capacity *= 2;
+            Table* grown = new Table();
+            grown->capacity = capacity;
+            grown->slots = new T*[capacity];
+            grown->retired = table;
+            for(size_t i = 0; i < capacity; i++)
+                grown->slots[i] = (table != (Table*) 0 && i < table->capacity) ? table->slots[i] : (T*) 0;
+            __atomic_store_n(&Multiton<T>::table, grown, __ATOMIC_RELEASE);
+            return grown;
+        }
+        // plain statics so they are usable before any dynamic initializer runs
+        static Table* table;
+        static size_t count;
+        static pthread_mutex_t mutex;
     };
     // define
     template <class T>
-    std::map<std::string, T*> Multiton<T>::instanceMap;
+    typename Multiton<T>::Table* Multiton<T>::table = 0;
+    template <class T>
+    size_t Multiton<T>::count = 0;
+    template <class T>
+    pthread_mutex_t Multiton<T>::mutex = PTHREAD_MUTEX_INITIALIZER;
     //--------------------------------------
     //  IMultitonKeyHeir
     //--------------------------------------
@@ -150,6 +432,7 @@ namespace PureMVC {
      * @see IFacade IFacade
      * @see INotification
      */
+    class Payload;
     class INotifier
     {
     public:
@@ -197,6 +480,36 @@ namespace PureMVC {
          * @param notificationName the name of the notification to send
          */
         virtual void sendNotification   ( int notificationName ) = 0;
+        /**
+         * Post a <code>INotification</code>.
+         *
+         * <p>
+         * Like <code>sendNotification</code>, but the notification is
+         * queued on the Core and delivered later by
+         * <code>Facade::pump</code> or the Core's event loop, so the
+         * caller never waits on the observers.</p>
+         *
+         * @param notificationName the name of the notification to post
+         * @param body the body of the notification (optional)
+         * @param type the type of the notification (optional)
+         */
+        virtual void postNotification   ( int notificationName, void* body, int notificationType) = 0;
+        virtual void postNotification   ( int notificationName, int notificationType ) = 0;
+        virtual void postNotification   ( int notificationName, void* body ) = 0;
+        virtual void postNotification   ( int notificationName ) = 0;
+        /**
+         * Post a <code>INotification</code> that owns its body.
+         *
+         * <p>
+         * The payload's value is transferred to the queued notification,
+         * leaving payload empty, and is destroyed after delivery.</p>
+         *
+         * @param notificationName the name of the notification to post
+         * @param payload the body, emptied by the call
+         * @param type the type of the notification (optional)
+         */
+        virtual void postNotification   ( int notificationName, Payload& payload, int notificationType ) = 0;
+        virtual void postNotification   ( int notificationName, Payload& payload ) = 0;
         /**
          * Initialize this INotifier instance.
          * <p>
@@ -330,7 +643,7 @@ namespace PureMVC {
              *
              * @param notification the <code>INotification</code> to execute the associated <code>ICommand</code> for
              */
-            //virtual void executeCommand( INotification* notification ) = 0;
+            virtual void executeCommand( INotification* notification ) = 0;
             /**
              * Remove a previously registered <code>ICommand</code> to <code>INotification</code> mapping.
              *
@@ -495,6 +808,80 @@ namespace PureMVC {
              */
             virtual void* getData() = 0;
     };
+    /**
+     * A handle for one proxy registration with an <code>IModel</code>.
+     *
+     * <P>
+     * Resolving a handle is an index and a compare, where resolving a
+     * name hashes it. Once the proxy is removed its slot may be reused,
+     * and the generation tells the stale handle apart from the new
+     * registration. A default constructed handle refers to nothing.</P>
+     *
+     * @see ProxyRef
+     */
+    class ProxyHandle
+    {
+    public:
+        ProxyHandle() : slot(0), generation(0) {}
+        ProxyHandle(unsigned int slot, unsigned int generation)
+            : slot(slot), generation(generation) {}
+        unsigned int slot;
+        unsigned int generation;
+    };
+    /**
+     * The interface definition for a factory of lazily registered proxies.
+     *
+     * @see IModel::registerProxyFactory
+     */
+    class IProxyFactory
+    {
+    public:
+        /**
+         * Construct the proxy to register as <code>proxyName</code>.
+         */
+        virtual IProxy* create( const std::string& proxyName ) = 0;
+        virtual ~IProxyFactory(){};
+    };
+    /**
+     * A <code>IProxyFactory</code> for <code>IProxy</code> class T,
+     * which is constructed with its name.
+     */
+    template<class T>
+    class ProxyFactory : public IProxyFactory
+    {
+    public:
+        IProxy* create( const std::string& proxyName )
+        {
+            return new T(proxyName);
+        }
+    };
+    /**
+     * A proxy to register with <code>registerProxies</code>, and the proxies it needs.
+     *
+     * <PRE>
+     * std::vector&lt;ProxyRegistration&gt; proxies;
+     * proxies.push_back(ProxyRegistration(new ConfigProxy()));
+     * proxies.push_back(ProxyRegistration(new UserProxy()).dependsOn(ConfigProxy::NAME));
+     * facade->registerProxies(proxies);
+     * </PRE>
+     */
+    class ProxyRegistration
+    {
+    public:
+        ProxyRegistration( IProxy* proxy ) : proxy(proxy) {}
+        /**
+         * Have this proxy's <code>onRegister</code> wait for that of another in the same batch.
+         *
+         * @param proxyName the name of the proxy this one needs
+         */
+        ProxyRegistration& dependsOn( const std::string& proxyName )
+        {
+            this->dependencies.push_back(proxyName);
+            return *this;
+        }
+        IProxy* proxy;
+        std::vector<std::string> dependencies;
+    };
     /**
      * The interface definition for a PureMVC Model.
      *
@@ -520,27 +907,54 @@ namespace PureMVC {
              * @param proxy an object reference to be held by the <code>Model</code>.
              */
             virtual void registerProxy( IProxy* proxy ) = 0;
+            /**
+             * Register an <code>IProxy</code> to be constructed when it is first retrieved.
+             *
+             * @param proxyName the name to register the <code>IProxy</code> as.
+             * @param factory constructs the <code>IProxy</code>, and is then deleted by the <code>Model</code>.
+             */
+            virtual void registerProxyFactory( std::string proxyName, IProxyFactory* factory ) = 0;
+            /**
+             * Register several <code>IProxy</code> instances, running their <code>onRegister</code> methods concurrently.
+             *
+             * @param registrations the proxies, and the proxies each of them depends on.
+             */
+            virtual void registerProxies( const std::vector<ProxyRegistration>& registrations ) = 0;
             /**
              * Retrieve an <code>IProxy</code> instance from the Model.
              *
              * @param proxyName
              * @return the <code>IProxy</code> instance previously registered with the given <code>proxyName</code>.
              */
-            virtual IProxy* retrieveProxy( std::string proxyName ) = 0;
+            virtual IProxy* retrieveProxy( StringRef proxyName ) = 0;
             /**
              * Remove an <code>IProxy</code> instance from the Model.
              *
              * @param proxyName name of the <code>IProxy</code> instance to be removed.
              * @return the <code>IProxy</code> that was removed from the <code>Model</code>
              */
-            virtual IProxy* removeProxy( std::string proxyName ) = 0;
+            virtual IProxy* removeProxy( StringRef proxyName ) = 0;
             /**
              * Check if a Proxy is registered
              *
              * @param proxyName
              * @return whether a Proxy is currently registered with the given <code>proxyName</code>.
              */
-            virtual bool hasProxy( std::string proxyName ) = 0;
+            virtual bool hasProxy( StringRef proxyName ) = 0;
+            /**
+             * Get a handle for the registration of an <code>IProxy</code>.
+             *
+             * @param proxyName
+             * @return a handle to the proxy registered as <code>proxyName</code>, or one that refers to nothing.
+             */
+            virtual ProxyHandle retrieveProxyHandle( StringRef proxyName ) = 0;
+            /**
+             * Retrieve an <code>IProxy</code> instance by handle.
+             *
+             * @param handle from <code>retrieveProxyHandle</code>
+             * @return the <code>IProxy</code>, or null if it has been removed since.
+             */
+            virtual IProxy* retrieveProxy( ProxyHandle handle ) = 0;
             virtual ~IModel(){};
     };
 
@@ -622,6 +1036,150 @@ namespace PureMVC {
 
             virtual ~IMediator(){};
     };
+    /**
+     * A notification callback stored by value.
+     *
+     * <P>
+     * A Delegate is a context pointer and a plain function pointer to a
+     * trampoline that casts the context back and calls the member
+     * function. The member function is a template argument of the
+     * trampoline, so the Delegate is two pointers wide, needs no heap
+     * object and no virtual call of its own. The <code>View</code>
+     * keeps Delegates inline in its observer lists, so notifying a list
+     * walks contiguous memory.</P>
+     *
+     * <P>
+     * <code>IObserverRestricted</code> instances are still accepted,
+     * the Delegate then calls through the observer.</P>
+     *
+     * <code>Delegate::bind<MyMediator, &MyMediator::onDataChanged>(this)</code>
+     *
+     * @see View::registerObserver
+     */
+    class Delegate
+    {
+    public:
+        typedef void (*Trampoline)(void* context, INotification* notification);
+        Delegate() : context(0), trampoline(0) {}
+        /**
+         * Wrap an <code>IObserverRestricted</code>.
+         *
+         * @param observer the observer to notify, still owned by the caller
+         */
+        Delegate( IObserverRestricted* observer )
+            : context(observer), trampoline(&Delegate::callObserver) {}
+        /**
+         * Pair a context with a trampoline of your own.
+         *
+         * @param context the interested object, also the address compared on removal
+         * @param trampoline called with context and the notification
+         */
+        Delegate( void* context, Trampoline trampoline )
+            : context(context), trampoline(trampoline) {}
+        /**
+         * Bind a member function to an object.
+         *
+         * @template T the class of the interested object
+         * @template method the notification method of the interested object
+         * @param context the interested object
+         */
+        template<class T, void (T::*method)(INotification*)>
+        static Delegate bind( T* context )
+        {
+            return Delegate(context, &Delegate::callMember<T, method>);
+        }
+        /**
+         * Bind a payload handler to an object.
+         *
+         * <P>
+         * The handler receives the body of the notification as a
+         * <code>const P&</code>; notifications without a body are
+         * not passed on.</P>
+         *
+         * @template P the payload type
+         * @template T the class of the interested object
+         * @template method the payload handler of the interested object
+         * @param context the interested object
+         */
+        template<class P, class T, void (T::*method)(const P&)>
+        static Delegate bindPayload( T* context )
+        {
+            return Delegate(context, &Delegate::callPayload<P, T, method>);
+        }
+        /**
+         * Notify the interested object.
+         */
+        void operator()( INotification* notification ) const
+        {
+            this->trampoline(this->context, notification);
+        }
+        /**
+         * Compare a memory address with the interested object's address.
+         *
+         * @param contextAddress the address to compare
+         * @return whether the interested object lives at contextAddress
+         */
+        bool compareNotifyContext( intptr_t contextAddress ) const
+        {
+            if(this->trampoline == &Delegate::callObserver)
+                return ((IObserverRestricted*) this->context)->compareNotifyContext(contextAddress);
+            return (intptr_t) this->context == contextAddress;
+        }
+        /**
+         * Check whether the interested object is notified through trampoline.
+         */
+        bool uses( Trampoline trampoline ) const
+        {
+            return this->trampoline == trampoline;
+        }
+        /**
+         * Get the interested object.
+         */
+        void* getContext() const
+        {
+            return this->context;
+        }
+    private:
+        template<class T, void (T::*method)(INotification*)>
+        static void callMember( void* context, INotification* notification )
+        {
+            (static_cast<T*>(context)->*method)(notification);
+        }
+        template<class P, class T, void (T::*method)(const P&)>
+        static void callPayload( void* context, INotification* notification )
+        {
+            void* payload = notification->getBody();
+            if(payload != (void*) 0)
+                (static_cast<T*>(context)->*method)(*static_cast<const P*>(payload));
+        }
+        static void callObserver( void* context, INotification* notification )
+        {
+            ((IObserverRestricted*) context)->notifyObserver(notification);
+        }
+        void* context;
+        Trampoline trampoline;
+    };
+    /**
+     * A handle for one observer registration with an <code>IView</code>.
+     *
+     * <P>
+     * Returned by <code>registerObserver</code> and handed back to
+     * <code>removeObserver</code> to unsubscribe without searching the
+     * observer list. A handle is only good for one removal; once the
+     * registration is gone its slot may be reused, and the generation
+     * tells the stale handle apart from the new one. A default
+     * constructed handle refers to nothing.</P>
+     */
+    class Subscription
+    {
+    public:
+        Subscription() : notificationName(0), slot(0), generation(0) {}
+        Subscription(int notificationName, unsigned int slot, unsigned int generation)
+            : notificationName(notificationName), slot(slot), generation(generation) {}
+        int notificationName;
+        unsigned int slot;
+        unsigned int generation;
+    };
     /**
      * The interface definition for a PureMVC View.
      *
@@ -652,8 +1210,18 @@ namespace PureMVC {
              *
              * @param notificationName the name of the <code>INotifications</code> to notify this <code>IObserver</code> of
              * @param observer the <code>IObserver</code> to register
+             * @return a handle for removing the registration
+             */
+            virtual Subscription registerObserver( int notificationName, IObserverRestricted* observer ) = 0;
+            /**
+             * Register a <code>Delegate</code> to be notified
+             * of <code>INotifications</code> with a given name.
+             *
+             * @param notificationName the name of the <code>INotifications</code> to notify the <code>Delegate</code> of
+             * @param delegate the <code>Delegate</code> to register
+             * @return a handle for removing the registration
              */
-            virtual void registerObserver( int notificationName, IObserverRestricted* observer ) = 0;
+            virtual Subscription registerObserver( int notificationName, Delegate delegate ) = 0;
             /**
              * Remove an observer from the observer list for a given Notification name that has a context
              * object stored at <code>contextAddress</code>.
@@ -662,6 +1230,14 @@ namespace PureMVC {
              * @param contextAddress remove the observer with this address as the address of their notifyContext
              */
             virtual void removeObserver( int notificationName, intptr_t contextAddress ) = 0;
+            /**
+             * Remove the observer registration a <code>Subscription</code> refers to.
+             * <p>
+             * Does nothing if the registration has already been removed.</p>
+             *
+             * @param subscription the handle returned by <code>registerObserver</code>
+             */
+            virtual void removeObserver( Subscription subscription ) = 0;
             /**
              * Notify the <code>IObservers</code> for a particular <code>INotification</code>.
              *
@@ -673,6 +1249,20 @@ namespace PureMVC {
              * @param notification the <code>INotification</code> to notify <code>IObservers</code> of.
              */
             virtual void notifyObservers( INotification* note ) = 0;
+            /**
+             * Notify the <code>IObservers</code> of a batch of <code>INotification</code>s.
+             *
+             * <p>
+             * Every notification in the batch has the same name and
+             * type and one of bodies. The observers are looked up once
+             * for the whole batch.</p>
+             *
+             * @param notificationName the name of every notification in the batch
+             * @param bodies the body of each notification
+             * @param count the number of bodies
+             * @param notificationType the type of every notification in the batch
+             */
+            virtual void notifyObserversBatch( int notificationName, void* const* bodies, size_t count, int notificationType ) = 0;
             /**
              * Register an <code>IMediator</code> instance with the <code>View</code>.
              *
@@ -742,27 +1332,40 @@ namespace PureMVC {
              * @param proxy the <code>IProxy</code> to be registered with the <code>Model</code>.
              */
             virtual void registerProxy( IProxy* proxy ) = 0;
+            /**
+             * Register an <code>IProxy</code> with the <code>Model</code>, to be constructed when it is first retrieved.
+             *
+             * @param proxyName the name to register the <code>IProxy</code> as.
+             * @param factory constructs the <code>IProxy</code>, and is then deleted by the <code>Model</code>.
+             */
+            virtual void registerProxyFactory( std::string proxyName, IProxyFactory* factory ) = 0;
+            /**
+             * Register several <code>IProxy</code> instances with the <code>Model</code>, running their <code>onRegister</code> methods concurrently.
+             *
+             * @param registrations the proxies, and the proxies each of them depends on.
+             */
+            virtual void registerProxies( const std::vector<ProxyRegistration>& registrations ) = 0;
             /**
              * Retrieve a <code>IProxy</code> from the <code>Model</code> by name.
              *
              * @param proxyName the name of the <code>IProxy</code> instance to be retrieved.
              * @return the <code>IProxy</code> previously regisetered by <code>proxyName</code> with the <code>Model</code>.
              */
-            virtual IProxy* retrieveProxy( std::string proxyName ) = 0;
+            virtual IProxy* retrieveProxy( StringRef proxyName ) = 0;
             /**
              * Remove an <code>IProxy</code> instance from the <code>Model</code> by name.
              *
              * @param proxyName the <code>IProxy</code> to remove from the <code>Model</code>.
              * @return the <code>IProxy</code> that was removed from the <code>Model</code>
              */
-            virtual IProxy* removeProxy( std::string proxyName ) = 0;
+            virtual IProxy* removeProxy( StringRef proxyName ) = 0;
             /**
              * Check if a Proxy is registered
              *
              * @param proxyName
              * @return whether a Proxy is currently registered with the given <code>proxyName</code>.
              */
-            virtual bool hasProxy( std::string proxyName ) = 0;
+            virtual bool hasProxy( StringRef proxyName ) = 0;
             /**
              * Register an <code>ICommand</code> with the <code>Controller</code>.
              *
@@ -824,6 +1427,22 @@ namespace PureMVC {
              * @param notification the <code>INotification</code> to have the <code>View</code> notify <code>Observers</code> of.
              */
             virtual void notifyObservers( INotification* notification ) = 0;
+            /**
+             * Send a batch of <code>INotification</code>s sharing a name and type.
+             *
+             * @param notificationName the name of every notification in the batch
+             * @param bodies the body of each notification
+             * @param count the number of bodies
+             * @param notificationType the type of every notification in the batch (optional)
+             */
+            virtual void sendNotifications( int notificationName, void* const* bodies, size_t count, int notificationType ) = 0;
+            virtual void sendNotifications( int notificationName, void* const* bodies, size_t count ) = 0;
+            /**
+             * Deliver posted <code>INotification</code>s.
+             *
+             * @return the number of notifications delivered
+             */
+            virtual unsigned int pump() = 0;
     };
 
     //--------------------------------------
@@ -836,6 +1455,11 @@ namespace PureMVC {
     class MultitonKeyHeir : public virtual IMultitonKeyHeir
     {
     public:
+        /**
+         *  Constructor.
+         *  The multiton key starts out empty.
+         */
+        MultitonKeyHeir();
         /**
          *  Set multiton key.
          *  Sets the multiton key.
@@ -848,19 +1472,284 @@ namespace PureMVC {
          *  @return The string key name
          */
         virtual std::string getMultitonKey();
+        /**
+         *  Get the interned multiton key.
+         *  @return The CoreId of the multiton key
+         */
+        CoreId getCoreId();
     private:
         std::string _multitonKey;
+        CoreId _coreId;
     };
     //--------------------------------------
-    //  Notification
+    //  Payload
     //--------------------------------------
     /**
-     * A base <code>INotification</code> implementation.
-     *
-     * <P>
-     * The Observer Pattern as implemented within PureMVC exists
-     * to support event-driven communication between the
-     * application and the actors of the MVC triad.</P>
+     * Tags a payload type, the address of <code>tag</code> is unique per T.
+     */
+    template<class T>
+    struct PayloadTag
+    {
+        static const char tag;
+    };
+    template<class T>
+    const char PayloadTag<T>::tag = 0;
+    /**
+     * An owned notification payload.
+     *
+     * <P>
+     * A Payload owns one value of any copyable type. Values up to
+     * <code>INLINE_SIZE</code> bytes live inside the Payload, bigger ones
+     * on the heap. A Payload is only copied when asked to, with
+     * <code>copy</code>: <code>transfer</code> hands its value to
+     * another Payload and leaves it empty, stealing the heap pointer
+     * instead of copying the value (inline values are copy-constructed
+     * into place, which is cheap at that size). The value is destroyed
+     * exactly once, by whichever Payload holds it last.</P>
+     *
+     * <P>
+     * A shared Payload, made with <code>setShared</code>, keeps its value
+     * in a reference counted block on the heap. <code>share</code> adds
+     * another reference without copying, and the last reference to go
+     * frees the value. The count is atomic, so shared values may be
+     * read from several threads at once; the values themselves must not
+     * be modified while shared.</P>
+     *
+     * @see Notification::setPayload
+     * @see Facade::postNotification
+     */
+    class Payload
+    {
+    public:
+        /**
+         * The largest value stored without a heap allocation.
+         */
+        static const size_t INLINE_SIZE = 32;
+        Payload() : object(0), tag(0), destroy(0), relocate(0), clone(0), shared(0) {}
+        ~Payload()
+        {
+            this->reset();
+        }
+        /**
+         * Own a copy of value.
+         */
+        template<class T>
+        void set( const T& value )
+        {
+            this->reset();
+            this->place(value, Fits<sizeof(T) <= INLINE_SIZE>());
+            this->tag = &PayloadTag<T>::tag;
+        }
+        /**
+         * Own a reference counted copy of value.
+         */
+        template<class T>
+        void setShared( const T& value )
+        {
+            this->reset();
+            SharedBlock<T>* block = new SharedBlock<T>(value);
+            this->object = &block->value;
+            this->shared = block;
+            this->destroy = &Payload::destroyShared<T>;
+            this->tag = &PayloadTag<T>::tag;
+        }
+        /**
+         * Take another reference to a shared payload.
+         *
+         * @param from a shared Payload
+         * @return false, leaving this Payload empty, if from is not shared
+         */
+        bool share( const Payload& from )
+        {
+            this->reset();
+            if(from.shared == (SharedCount*) 0)
+                return false;
+            __atomic_add_fetch(&from.shared->references, 1, __ATOMIC_RELAXED);
+            this->object = from.object;
+            this->tag = from.tag;
+            this->destroy = from.destroy;
+            this->shared = from.shared;
+            return true;
+        }
+        /**
+         * Own a copy of the value of another Payload, or share it if it is shared.
+         *
+         * @return false, leaving this Payload empty, if from is empty
+         */
+        bool copy( const Payload& from )
+        {
+            if(&from == this)
+                return ! this->empty();
+            if(from.shared != (SharedCount*) 0)
+                return this->share(from);
+            this->reset();
+            if(from.object == (void*) 0)
+                return false;
+            this->object = from.clone(&this->storage, from.object);
+            this->tag = from.tag;
+            this->destroy = from.destroy;
+            this->relocate = from.relocate;
+            this->clone = from.clone;
+            return true;
+        }
+        /**
+         * Take over the value of another Payload, leaving it empty.
+         */
+        void transfer( Payload& from )
+        {
+            if(&from == this)
+                return;
+            this->reset();
+            if(from.object == (void*) 0)
+                return;
+            if(from.relocate != 0)
+                this->object = from.relocate(&this->storage, from.object);
+            else
+                this->object = from.object;
+            this->tag = from.tag;
+            this->destroy = from.destroy;
+            this->relocate = from.relocate;
+            this->clone = from.clone;
+            this->shared = from.shared;
+            from.forget();
+        }
+        /**
+         * Get the value.
+         *
+         * @return the value, or null if empty or not a T
+         */
+        template<class T>
+        T* get()
+        {
+            return this->tag == &PayloadTag<T>::tag ? (T*) this->object : (T*) 0;
+        }
+        /**
+         * Get the value without checking its type.
+         */
+        void* data()
+        {
+            return this->object;
+        }
+        bool empty()
+        {
+            return this->object == (void*) 0;
+        }
+        bool isShared()
+        {
+            return this->shared != (SharedCount*) 0;
+        }
+        /**
+         * Destroy the value, or drop this reference to a shared one.
+         */
+        void reset()
+        {
+            if(this->object != (void*) 0)
+                this->destroy(this->object, this->shared);
+            this->forget();
+        }
+    private:
+        Payload(Payload const&);
+        Payload& operator=(Payload const&);
+        struct SharedCount
+        {
+            int references;
+        };
+        template<class T>
+        struct SharedBlock : public SharedCount
+        {
+            SharedBlock( const T& value ) : value(value)
+            {
+                this->references = 1;
+            }
+            T value;
+        };
+        template<bool inlined>
+        struct Fits {};
+        template<class T>
+        void place( const T& value, Fits<true> )
+        {
+            this->object = new(&this->storage) T(value);
+            this->destroy = &Payload::destroyInline<T>;
+            this->relocate = &Payload::relocateInline<T>;
+            this->clone = &Payload::cloneInline<T>;
+        }
+        template<class T>
+        void place( const T& value, Fits<false> )
+        {
+            this->object = new T(value);
+            this->destroy = &Payload::destroyHeap<T>;
+            this->clone = &Payload::cloneHeap<T>;
+        }
+        template<class T>
+        static void destroyInline( void* object, SharedCount* )
+        {
+            ((T*) object)->~T();
+        }
+        template<class T>
+        static void* relocateInline( void* storage, void* object )
+        {
+            T* moved = new(storage) T(*(T*) object);
+            ((T*) object)->~T();
+            return moved;
+        }
+        template<class T>
+        static void* cloneInline( void* storage, const void* object )
+        {
+            return new(storage) T(*(const T*) object);
+        }
+        template<class T>
+        static void* cloneHeap( void*, const void* object )
+        {
+            return new T(*(const T*) object);
+        }
+        template<class T>
+        static void destroyHeap( void* object, SharedCount* )
+        {
+            delete (T*) object;
+        }
+        template<class T>
+        static void destroyShared( void*, SharedCount* shared )
+        {
+            if(__atomic_sub_fetch(&shared->references, 1, __ATOMIC_ACQ_REL) == 0)
+                delete static_cast<SharedBlock<T>*>(shared);
+        }
+        void forget()
+        {
+            this->object = 0;
+            this->tag = 0;
+            this->destroy = 0;
+            this->relocate = 0;
+            this->clone = 0;
+            this->shared = 0;
+        }
+        // the value, inside storage, on the heap or in a shared block
+        void* object;
+        const char* tag;
+        void (*destroy)(void* object, SharedCount* shared);
+        // set for inline values, which have to be copied out of storage
+        void* (*relocate)(void* storage, void* object);
+        // set for owned values, copies one into storage or onto the heap
+        void* (*clone)(void* storage, const void* object);
+        // the block of a shared value, null otherwise
+        SharedCount* shared;
+        union
+        {
+            unsigned char bytes[INLINE_SIZE];
+            long double alignDouble;
+            long long alignLong;
+            void* alignPointer;
+        } storage;
+    };
+    //--------------------------------------
+    //  Notification
+    //--------------------------------------
+    /**
+     * A base <code>INotification</code> implementation.
+     *
+     * <P>
+     * The Observer Pattern as implemented within PureMVC exists
+     * to support event-driven communication between the
+     * application and the actors of the MVC triad.</P>
      *
      * <P>
      * <code>IMediator</code> implementors
@@ -896,6 +1785,16 @@ namespace PureMVC {
         Notification(int notificationName, void* body);
         Notification(int notificationName, int notificationType);
         Notification(int notificationName);
+        /**
+         * Copy constructor.
+         *
+         * <P>
+         * Copies the name, type and body. A shared payload is shared with
+         * the copy and an owned one is copied, so the copy's body
+         * outlives the original either way.</P>
+         */
+        Notification(Notification const& notification);
+        Notification& operator=(Notification const& notification);
         /**
          * Get the name of the <code>Notification</code> instance.
          *
@@ -904,8 +1803,73 @@ namespace PureMVC {
         int getName();
         /**
          * Set the body of the <code>Notification</code> instance.
+         *
+         * <P>
+         * Drops the payload, if there is one.</P>
          */
         void setBody( void* body );
+        /**
+         * Give the <code>Notification</code> its own copy of a value as its body.
+         *
+         * <P>
+         * The payload lives as long as the notification (or whatever it
+         * is transferred to), so it is safe to queue or hand to another
+         * thread, unlike a body pointing at a local.</P>
+         *
+         * @param value the value to copy into the payload
+         */
+        template<class T>
+        void setPayload( const T& value )
+        {
+            this->payload.set(value);
+            this->body = this->payload.data();
+        }
+        /**
+         * Give the <code>Notification</code> a reference counted copy of a value as its body.
+         *
+         * <P>
+         * Copies of the notification share the value instead of borrowing it.</P>
+         *
+         * @param value the value to copy into the payload
+         */
+        template<class T>
+        void setSharedPayload( const T& value )
+        {
+            this->payload.setShared(value);
+            this->body = this->payload.data();
+        }
+        /**
+         * Take over the value of a <code>Payload</code> as the body.
+         *
+         * @param from the Payload to empty
+         */
+        void takePayload( Payload& from );
+        /**
+         * Get the payload.
+         *
+         * @return the payload, or null if there is none or it is not a T
+         */
+        template<class T>
+        T* getPayloadAs()
+        {
+            return this->payload.get<T>();
+        }
+        /**
+         * Check whether the body is a payload owned by this <code>Notification</code>.
+         */
+        bool hasPayload();
+        /**
+         * Copy this notification into one that will outlive it.
+         *
+         * <P>
+         * Used to hold on to a sent notification for later delivery. The
+         * base class copies like <code>operator=</code>, so a payload is
+         * copied but any other body is still only borrowed; subclasses
+         * that know what their body is may copy it into the payload.</P>
+         *
+         * @param copy the notification to copy into
+         */
+        virtual void copyTo( Notification& copy );
         /**
          * Get the body of the <code>Notification</code> instance.
          *
@@ -922,6 +1886,89 @@ namespace PureMVC {
          * @return the type
          */
         int getType();
+        /**
+         * The first notification name reserved for <code>TypedNotification</code>s.
+         *
+         * <P>
+         * Typed notification names are handed out upwards from here, one
+         * per payload type, so don't use names this low for your own.</P>
+         */
+        static const int FIRST_TYPED_NAME = INT_MIN;
+        /**
+         * How many typed notification names the <code>View</code> indexes directly.
+         */
+        static const int MAX_TYPED_NAMES = 65536;
+        /**
+         * Reserve the next typed notification name.
+         *
+         * @return a name no other payload type has
+         */
+        static int allocateTypedName();
+    protected:
+        // the owned body, empty when the body is borrowed
+        Payload payload;
+    };
+    /**
+     * Keeps a template parameter from being deduced, so callers have to name it.
+     */
+    template<class T>
+    struct Named
+    {
+        typedef T type;
+    };
+    /**
+     * A <code>Notification</code> whose payload type is its identity.
+     *
+     * <P>
+     * Every payload type P gets its own notification name the first time
+     * it is used, so observers of <code>TypedNotification<P>::notificationName()</code>
+     * know the body is a <code>P</code> without looking at the type.
+     * The payload is not copied, the notification only points at it,
+     * unless the notification is kept for later (see <code>copyTo</code>),
+     * so payload types have to be copyable.</P>
+     *
+     * <P>
+     * Typed notifications travel the ordinary int-named path, so a
+     * mediator can list <code>TypedNotification<P>::notificationName()</code>
+     * among its interests and read the payload from the body.</P>
+     *
+     * @see Facade::subscribe
+     */
+    template<class P>
+    class TypedNotification : public Notification
+    {
+    public:
+        /**
+         * Constructor.
+         *
+         * @param payload the payload, which must outlive the notification
+         */
+        TypedNotification( const P& payload )
+            : Notification(TypedNotification<P>::notificationName(), (void*) &payload) {}
+        /**
+         * Get the payload.
+         */
+        const P& getPayload()
+        {
+            return *(const P*) this->getBody();
+        }
+        /**
+         * Copy this notification, and its payload, into one that will outlive it.
+         */
+        void copyTo( Notification& copy )
+        {
+            copy.name = this->name;
+            copy.type = this->type;
+            copy.setPayload<P>(this->getPayload());
+        }
+        /**
+         * Get the notification name of payload type P.
+         */
+        static int notificationName()
+        {
+            static const int name = Notification::allocateTypedName();
+            return name;
+        }
     };
     //--------------------------------------
     //  Notifier
@@ -964,6 +2011,10 @@ namespace PureMVC {
     class Notifier : public MultitonKeyHeir, public virtual INotifier
     {
     public:
+        /**
+         * Constructor.
+         */
+        Notifier();
         /**
          * Create and send an <code>INotification</code>.
          *
@@ -978,6 +2029,36 @@ namespace PureMVC {
         void sendNotification   ( int notificationName, int notificationType );
         void sendNotification   ( int notificationName, void* body );
         void sendNotification   ( int notificationName );
+        /**
+         * Create and send a <code>TypedNotification</code>.
+         *
+         * <P>
+         * <code>sendNotification<SetTitle>(title)</code>. The payload
+         * type has to be named.</P>
+         * @param payload the payload, borrowed for the duration of the call
+         */
+        template<class P>
+        void sendNotification   ( const typename Named<P>::type& payload )
+        {
+            TypedNotification<P> notification(payload);
+            this->getFacade()->notifyObservers(&notification);
+        }
+        /**
+         * Create and post an <code>INotification</code>.
+         *
+         * <P>
+         * The notification is queued on this Notifier's Core and
+         * delivered by <code>Facade::pump</code> or the Core's event loop.</P>
+         * @param notificationName the name of the notiification to post
+         * @param body the body of the notification (optional)
+         * @param type the type of the notification (optional)
+         */
+        void postNotification   ( int notificationName, void* body, int notificationType);
+        void postNotification   ( int notificationName, int notificationType );
+        void postNotification   ( int notificationName, void* body );
+        void postNotification   ( int notificationName );
+        void postNotification   ( int notificationName, Payload& payload, int notificationType );
+        void postNotification   ( int notificationName, Payload& payload );
         /**
          * Initialize this INotifier instance.
          * <P>
@@ -999,7 +2080,25 @@ namespace PureMVC {
         void initializeNotifier(std::string key);
 
     protected:
+        /**
+         * Get the <code>Facade</code> for this Notifier's multitonKey.
+         *
+         * <P>
+         * The facade is looked up once and cached. The cache is dropped
+         * when <code>initializeNotifier</code> is called again or when any
+         * Core is removed with <code>Facade::removeCore</code>. Like
+         * <code>Facade::getInstance</code>, it creates the Core if there
+         * is none, and never returns a facade that is still being
+         * initialized. It may be called from several threads at once.</P>
+         */
         IFacade* getFacade();
+
+    private:
+        void cacheFacade( IFacade* facade, unsigned long generation );
+        // the cached facade and one past the core generation it was
+        // resolved in, 0 while nothing is cached
+        IFacade* facade;
+        unsigned long facadeGeneration;
     };
     //--------------------------------------
     //  SimpleCommand
@@ -1290,36 +2389,209 @@ namespace PureMVC {
         // the data object
         void* data;
     };
-    //--------------------------------------
-    //  Mediator
-    //--------------------------------------
-    class Mediator : public IMediator, public Notifier
+    /**
+     * Lets a writer wait out readers that may still be looking at what it just replaced.
+     *
+     * <P>
+     * Readers bracket their look with <code>enter</code> and
+     * <code>leave</code>, which never block. A writer that has swapped a
+     * shared pointer calls <code>wait</code>, which returns once every
+     * reader that entered before the swap has left, so the old pointee is
+     * no longer being looked at. Readers that enter after the swap don't
+     * hold the writer up. Writers must not wait concurrently.</P>
+     */
+    class GracePeriod
     {
     public:
+        GracePeriod();
         /**
-         * Constructor.
+         * Start reading.
+         *
+         * @return the token to hand to <code>leave</code>
          */
-        Mediator( std::string mediatorName, void* viewComponent );
-        Mediator( std::string mediatorName );
-        Mediator( void* viewComponent );
-        
+        unsigned int enter();
         /**
-         * Get the name of the <code>Mediator</code>.
-         * @return the Mediator name
+         * Stop reading.
          */
-        std::string getMediatorName();
-
+        void leave( unsigned int token );
         /**
-         * Set the <code>IMediator</code>'s view component.
-         *
-         * @param Object the view component
+         * Wait for the readers that entered before this call to leave.
          */
-        void setViewComponent( void* viewComponent );
-
+        void wait();
+    private:
+        unsigned int epoch;
+        // readers inside, by the parity of the epoch they entered in
+        int readers[2];
+    };
+    /**
+     * A <code>Proxy</code> whose data is published as immutable, numbered versions.
+     *
+     * <P>
+     * <code>publish</code> copies the data into a new version and
+     * swaps it in; <code>read</code> returns a <code>Snapshot</code> of
+     * whichever version is current. A snapshot keeps its version alive
+     * for as long as it is held, so readers on any thread see a
+     * consistent value however often the data is published meanwhile.
+     * Reading never blocks; publishing waits only for readers that are
+     * in the middle of taking a snapshot, never for ones holding one.</P>
+     *
+     * <P>
+     * Every version has a number, one more than the last. A mediator
+     * that remembers the number it last rendered can compare it with
+     * <code>getVersion</code> and skip data that hasn't changed.</P>
+     *
+     * <P>
+     * The data is not reachable through <code>getData</code>, which
+     * would hand it out without a snapshot.</P>
+     */
+    template<class T>
+    class VersionedProxy : public Proxy
+    {
+    private:
+        struct Version
+        {
+            Version( const T& data, unsigned long number ) : data(data), number(number), references(1) {}
+            T data;
+            unsigned long number;
+            int references;
+        };
+        static void release( Version* version )
+        {
+            if(__atomic_sub_fetch(&version->references, 1, __ATOMIC_ACQ_REL) == 0)
+                delete version;
+        }
+    public:
         /**
-         * Get the <code>Mediator</code>'s view component.
+         * One version of a <code>VersionedProxy</code>'s data, kept alive while it is held.
+         */
+        class Snapshot
+        {
+        public:
+            Snapshot() : version((Version*) 0) {}
+            Snapshot( const Snapshot& other ) : version(other.version)
+            {
+                if(this->version != (Version*) 0)
+                    __atomic_add_fetch(&this->version->references, 1, __ATOMIC_RELAXED);
+            }
+            Snapshot& operator=( const Snapshot& other )
+            {
+                Snapshot copy(other);
+                Version* swapped = this->version;
+                this->version = copy.version;
+                copy.version = swapped;
+                return *this;
+            }
+            ~Snapshot()
+            {
+                if(this->version != (Version*) 0)
+                    VersionedProxy<T>::release(this->version);
+            }
+            const T& operator*() const
+            {
+                return this->version->data;
+            }
+            const T* operator->() const
+            {
+                return &this->version->data;
+            }
+            /**
+             * Get the number of this version, or 0 for an empty snapshot.
+             */
+            unsigned long getVersion() const
+            {
+                return this->version == (Version*) 0 ? 0 : this->version->number;
+            }
+        private:
+            friend class VersionedProxy<T>;
+            Snapshot( Version* version ) : version(version) {}
+            Version* version;
+        };
+        /**
+         * Constructor.
          *
-         * <P>
+         * @param proxyName the proxy name
+         * @param data the first version, numbered 1
+         */
+        VersionedProxy( std::string proxyName, const T& data = T() ) : Proxy(proxyName)
+        {
+            this->current = new Version(data, 1);
+        }
+        ~VersionedProxy()
+        {
+            VersionedProxy<T>::release(this->current);
+        }
+        /**
+         * Take a snapshot of the current version. May be called from any thread.
+         */
+        Snapshot read()
+        {
+            unsigned int token = this->readers.enter();
+            Version* version = __atomic_load_n(&this->current, __ATOMIC_ACQUIRE);
+            __atomic_add_fetch(&version->references, 1, __ATOMIC_RELAXED);
+            this->readers.leave(token);
+            return Snapshot(version);
+        }
+        /**
+         * Publish a copy of data as the next version. May be called from any thread.
+         *
+         * @return the number of the new version
+         */
+        unsigned long publish( const T& data )
+        {
+            ScopedLock lock(this->writing);
+            Version* version = new Version(data, this->current->number + 1);
+            Version* old = __atomic_exchange_n(&this->current, version, __ATOMIC_ACQ_REL);
+            // a reader may have loaded the old version and not counted itself yet
+            this->readers.wait();
+            VersionedProxy<T>::release(old);
+            return version->number;
+        }
+        /**
+         * Get the number of the current version.
+         */
+        unsigned long getVersion()
+        {
+            unsigned int token = this->readers.enter();
+            unsigned long number = __atomic_load_n(&this->current, __ATOMIC_ACQUIRE)->number;
+            this->readers.leave(token);
+            return number;
+        }
+    private:
+        Version* current;
+        GracePeriod readers;
+        // one publisher at a time
+        Mutex writing;
+    };
+    //--------------------------------------
+    //  Mediator
+    //--------------------------------------
+    class Mediator : public IMediator, public Notifier
+    {
+    public:
+        /**
+         * Constructor.
+         */
+        Mediator( std::string mediatorName, void* viewComponent );
+        Mediator( std::string mediatorName );
+        Mediator( void* viewComponent );
+        
+        /**
+         * Get the name of the <code>Mediator</code>.
+         * @return the Mediator name
+         */
+        std::string getMediatorName();
+
+        /**
+         * Set the <code>IMediator</code>'s view component.
+         *
+         * @param Object the view component
+         */
+        void setViewComponent( void* viewComponent );
+
+        /**
+         * Get the <code>Mediator</code>'s view component.
+         *
+         * <P>
          * Additionally, an implicit getter will usually
          * be defined in the subclass that casts the view
          * object to a type, like this:</P>
@@ -1353,6 +2625,24 @@ namespace PureMVC {
          */
         virtual void handleNotification( INotification* notification ) = 0;
 
+        /**
+         * Handle a batch of <code>INotification</code>s sharing a name and type.
+         *
+         * <P>
+         * Passes each one to <code>handleNotification</code>. Override it
+         * to handle bulk traffic in one go, with the bodies side by side.
+         * The <code>View</code> calls it for
+         * <code>Facade::sendNotifications</code>. It is not part of
+         * <code>IMediator</code>, whose other implementers get a batch
+         * one notification at a time.</P>
+         *
+         * @param notificationName the name of every notification in the batch
+         * @param bodies the body of each notification
+         * @param count the number of bodies
+         * @param notificationType the type of every notification in the batch
+         */
+        virtual void handleNotifications( int notificationName, void* const* bodies, size_t count, int notificationType );
+
         /**
          * Called by the View when the Mediator is registered
          */
@@ -1380,6 +2670,75 @@ namespace PureMVC {
     //--------------------------------------
     //  Model
     //--------------------------------------
+    /**
+     * The names of a <code>Model</code>'s proxies and the slots they are kept in.
+     *
+     * <P>
+     * An open addressing hash table, probed linearly. Lookups take a
+     * <code>StringRef</code> and never insert, so looking for a proxy
+     * neither allocates nor registers anything. Removal shifts the
+     * entries behind the removed one back, so there are no tombstones
+     * to grow over.</P>
+     *
+     * <P>
+     * Lookups never lock, and may run while a name is inserted: an
+     * entry is filled in before its slot is published, and a growing
+     * table is copied and the copy published, the way
+     * <code>Multiton</code> grows its tables. Inserting and erasing
+     * have to be kept to one thread at a time, and erasing must not
+     * race lookups.</P>
+     */
+    class ProxyMap
+    {
+    public:
+        static const unsigned int NONE = UINT_MAX;
+        ProxyMap();
+        ~ProxyMap();
+        /**
+         * Get the slot registered by name, or <code>NONE</code>.
+         */
+        unsigned int find( StringRef name ) const;
+        /**
+         * Register a slot by name, unless the name is taken.
+         *
+         * @return whether the name was added
+         */
+        bool insert( const std::string& name, unsigned int slot );
+        /**
+         * Unregister a name.
+         *
+         * @return the slot that was registered by name, or <code>NONE</code>
+         */
+        unsigned int erase( StringRef name );
+        size_t size() const;
+    private:
+        struct Entry
+        {
+            Entry() : hash(0), slot(ProxyMap::NONE) {}
+            size_t hash;
+            std::string name;
+            unsigned int slot;  // NONE when the entry is empty
+        };
+        /**
+         *  A published entry array.
+         *  Kept until the map goes: a lock-free lookup may still be
+         *  probing it. Arrays double in size, so the retired ones add up
+         *  to less than the live one.
+         */
+        struct Table
+        {
+            size_t capacity;
+            Entry* entries;
+            Table* retired;
+        };
+        ProxyMap(ProxyMap const&);
+        ProxyMap& operator=(ProxyMap const&);
+        static size_t hash( StringRef name );
+        static size_t slot( const Table* table, StringRef name, size_t hash );
+        void grow();
+        Table* table;
+        size_t count;
+    };
     /**
      * A Multiton <code>IModel</code> implementation.
      *
@@ -1425,6 +2784,7 @@ namespace PureMVC {
          *
          */
         Model();
+        ~Model();
 
         /**
          *  <code>Model</code> Multiton Factory method.
@@ -1438,21 +2798,99 @@ namespace PureMVC {
          * @param proxy an <code>IProxy</code> to be held by the <code>Model</code>.
          */
         void registerProxy( IProxy* proxy );
+        /**
+         * Register an <code>IProxy</code> to be constructed when it is first retrieved.
+         *
+         * <P>
+         * Nothing is constructed until the name is retrieved, by name or
+         * by handle; then the factory constructs the proxy, it is
+         * registered and its <code>onRegister</code> called, and the
+         * factory is deleted. <code>hasProxy</code> is true in the
+         * meantime. Removing the name before then deletes the factory and
+         * returns null.</P>
+         *
+         * <P>
+         * A lazy proxy may be retrieved from several threads at once: it
+         * is constructed exactly once, and no thread gets it before its
+         * <code>onRegister</code> has returned. That
+         * <code>onRegister</code> may register proxies of its own while
+         * other threads retrieve: registration is serialized, and
+         * registered proxies never move. Removing proxies still has to
+         * be kept from racing retrievals, as ever.</P>
+         *
+         * @param proxyName the name to register the <code>IProxy</code> as.
+         * @param factory constructs the <code>IProxy</code>, and is then deleted by the <code>Model</code>.
+         */
+        void registerProxyFactory( std::string proxyName, IProxyFactory* factory );
+        /**
+         * Register an <code>IProxy</code> of class T to be constructed, with its name, when it is first retrieved.
+         */
+        template<class T>
+        void registerProxyFactory( std::string proxyName )
+        {
+            this->registerProxyFactory(proxyName, new ProxyFactory<T>());
+        }
+        /**
+         * Register several <code>IProxy</code> instances, running their <code>onRegister</code> methods concurrently.
+         *
+         * <P>
+         * Every name is registered first, then the <code>onRegister</code>
+         * methods run on the shared <code>ThreadPool</code>, and on the
+         * calling thread, which helps out. A proxy's <code>onRegister</code>
+         * starts only once those of the proxies it depends on have
+         * returned, so it may retrieve them. Until its own
+         * <code>onRegister</code> has returned, a proxy's name is taken but
+         * <code>hasProxy</code> is false and it retrieves as null. Returns
+         * when every <code>onRegister</code> has, so the <code>Model</code>
+         * is ready to be announced.</P>
+         *
+         * <P>
+         * As with <code>registerProxy</code>, names already taken are
+         * skipped. Dependencies on proxies outside the batch are taken as
+         * met. Proxies caught in a cycle of dependencies, and the ones that
+         * depend on them, are registered one by one on the calling thread
+         * after the rest, in the order given.</P>
+         *
+         * <P>
+         * The <code>onRegister</code> methods run concurrently, so they must
+         * not register or remove proxies themselves. Lazy proxies they
+         * retrieve may: the slots of the batch stay where they are. Nor
+         * may they <code>sendNotification</code>, which would run the
+         * <code>View</code> on several threads at once; they
+         * <code>postNotification</code> instead, and the notifications are
+         * delivered by the Core's <code>pump</code> once the batch is
+         * in.</P>
+         *
+         * @param registrations the proxies, and the proxies each of them depends on.
+         */
+        void registerProxies( const std::vector<ProxyRegistration>& registrations );
         /**
          * Retrieve an <code>IProxy</code> from the <code>Model</code>.
          *
+         * <P>
+         * Looking for a name that is not registered returns null and
+         * leaves the <code>Model</code> as it was.</P>
+         *
          * @param proxyName
          * @return the <code>IProxy</code> instance previously registered with the given <code>proxyName</code>.
          */
-        IProxy* retrieveProxy( std::string proxyName );
+        IProxy* retrieveProxy( StringRef proxyName );
 
         /**
          * Check if a Proxy is registered
          *
+         * <P>
+         * True for a lazy proxy that has not been constructed yet, which
+         * retrieving constructs. False for a proxy of a
+         * <code>registerProxies</code> batch until its
+         * <code>onRegister</code> has returned, though its name is taken:
+         * whenever this is true, <code>retrieveProxy</code> finds the
+         * proxy.</P>
+         *
          * @param proxyName
          * @return whether a Proxy is currently registered with the given <code>proxyName</code>.
          */
-        bool hasProxy( std::string proxyName );
+        bool hasProxy( StringRef proxyName );
 
         /**
          * Remove an <code>IProxy</code> from the <code>Model</code>.
@@ -1460,7 +2898,21 @@ namespace PureMVC {
          * @param proxyName name of the <code>IProxy</code> instance to be removed.
          * @return the <code>IProxy</code> that was removed from the <code>Model</code>
          */
-        IProxy* removeProxy( std::string proxyName );
+        IProxy* removeProxy( StringRef proxyName );
+        /**
+         * Get a handle for the registration of an <code>IProxy</code>.
+         *
+         * @param proxyName
+         * @return a handle to the proxy registered as <code>proxyName</code>, or one that refers to nothing.
+         */
+        ProxyHandle retrieveProxyHandle( StringRef proxyName );
+        /**
+         * Retrieve an <code>IProxy</code> by handle.
+         *
+         * @param handle from <code>retrieveProxyHandle</code>
+         * @return the <code>IProxy</code>, or null if it has been removed since.
+         */
+        IProxy* retrieveProxy( ProxyHandle handle );
 
         /**
          * Remove an IModel instance
@@ -1471,7 +2923,116 @@ namespace PureMVC {
 
     protected:
         // Mapping of proxyNames to IProxy instances
-        std::map <std::string, IProxy*> proxyMap;
+        ProxyMap proxyMap;
+        // where names and handles find their proxies, free slots are reused
+        struct ProxySlot
+        {
+            ProxySlot() : proxy((IProxy*) 0), factory((IProxyFactory*) 0), constructing((IProxy*) 0), pending(false), generation(1) {}
+            IProxy* proxy;              // null until a lazy proxy is constructed
+            IProxyFactory* factory;     // set while a lazy proxy is not
+            IProxy* constructing;       // a lazy proxy in its onRegister
+            bool pending;               // in a batch, its onRegister not yet returned
+            std::string name;           // what a lazy proxy is constructed as
+            unsigned int generation;
+        };
+        // slots live in chunks that never move, chunk k holding
+        // FIRST_CHUNK << k of them, so lock-free readers can keep
+        // using a slot while more are added
+        static const unsigned int FIRST_CHUNK = 16;
+        static const int SLOT_CHUNKS = 28;
+        ProxySlot* slotChunks[SLOT_CHUNKS];
+        unsigned int slotCount;
+        std::vector<unsigned int> freeProxySlots;
+        // serializes registering, removing and constructing lazy
+        // proxies, recursive for onRegister
+        Mutex registration;
+        ProxySlot& slotAt( unsigned int slot );
+        // hand a batch proxy whose onRegister has returned to retrievers
+        void publish( unsigned int slot, IProxy* proxy );
+        unsigned int allocateSlot();
+        void freeSlot( unsigned int slot );
+        IProxy* proxyIn( unsigned int slot );
+    private:
+        class ProxyBatch;
+        class ProxyBatchTask;
+    };
+    /**
+     * A typed handle for a registered proxy.
+     *
+     * <P>
+     * Look a proxy up once, when it has been registered, and keep the
+     * <code>ProxyRef</code>: getting the proxy from it then costs an
+     * index and a generation compare, with no name to hash and no cast
+     * to write. Once the proxy is removed the reference gets null, even
+     * if a proxy is registered again under the same name; look it up
+     * again to follow the new one. A reference must not outlive the core
+     * it was looked up in.</P>
+     *
+     * <PRE>
+     * ProxyRef&lt;SocketProxy&gt; socket(getFacade(), SocketProxy::NAME);
+     * ...
+     * if(socket)
+     *     socket->reply(response);
+     * </PRE>
+     *
+     * @see ProxyHandle
+     */
+    template<class T>
+    class ProxyRef
+    {
+    public:
+        /**
+         * Constructor, for a reference to nothing.
+         */
+        ProxyRef() : model((IModel*) 0), proxy((T*) 0) {}
+        /**
+         * Constructor.
+         *
+         * <P>
+         * Refers to nothing if no proxy is registered as
+         * <code>proxyName</code>, or if it isn't a <code>T</code>.</P>
+         *
+         * @param model the <code>IModel</code> the proxy is registered with
+         * @param proxyName the name of the proxy
+         */
+        ProxyRef( IModel* model, StringRef proxyName )
+        {
+            this->resolve(model, proxyName);
+        }
+        /**
+         * Constructor, for a proxy registered through a facade.
+         */
+        ProxyRef( IFacade* facade, StringRef proxyName )
+        {
+            this->resolve(Model::getInstance(facade->getMultitonKey()), proxyName);
+        }
+        /**
+         * Get the proxy, or null if it has been removed.
+         */
+        T* get() const
+        {
+            if(this->proxy == (T*) 0 || this->model->retrieveProxy(this->handle) == (IProxy*) 0)
+                return (T*) 0;
+            return this->proxy;
+        }
+        T* operator->() const
+        {
+            return this->get();
+        }
+        operator bool() const
+        {
+            return this->get() != (T*) 0;
+        }
+    private:
+        void resolve( IModel* model, StringRef proxyName )
+        {
+            this->model = model;
+            this->handle = model->retrieveProxyHandle(proxyName);
+            this->proxy = dynamic_cast<T*>(model->retrieveProxy(this->handle));
+        }
+        IModel* model;
+        ProxyHandle handle;
+        T* proxy;
     };
 
     //--------------------------------------
@@ -1528,8 +3089,38 @@ namespace PureMVC {
          *
          * @param notificationName the name of the <code>INotifications</code> to notify this <code>IObserver</code> of
          * @param observer the <code>IObserverRestricted</code> to register
+         * @return a handle for removing the registration
+         */
+        Subscription registerObserver ( int notificationName, IObserverRestricted* observer );
+        /**
+         * Register a <code>Delegate</code> to be notified
+         * of <code>INotifications</code> with a given name.
+         *
+         * <P>
+         * The Delegate is copied into the observer list, so nothing is
+         * allocated per registration beyond the list's own storage.</P>
+         *
+         * @param notificationName the name of the <code>INotifications</code> to notify the <code>Delegate</code> of
+         * @param delegate the <code>Delegate</code> to register
+         * @return a handle for removing the registration
+         */
+        Subscription registerObserver ( int notificationName, Delegate delegate );
+        /**
+         * Register a payload handler for <code>TypedNotification</code>s of P.
+         *
+         * <P>
+         * <code>view->subscribe<SetTitle, MyMediator, &MyMediator::setTitle>(this)</code>.
+         * The handler is bound at compile time and takes a
+         * <code>const P&</code>, so it needs no switch and no cast.</P>
+         *
+         * @param context the interested object
+         * @return a handle for <code>removeObserver</code>
          */
-        void registerObserver ( int notificationName, IObserverRestricted* observer );
+        template<class P, class T, void (T::*method)(const P&)>
+        Subscription subscribe( T* context )
+        {
+            return this->registerObserver(TypedNotification<P>::notificationName(), Delegate::bindPayload<P, T, method>(context));
+        }
         /**
          * Notify the <code>IObservers</code> for a particular <code>INotification</code>.
          *
@@ -1541,15 +3132,44 @@ namespace PureMVC {
          * @param notification the <code>INotification</code> to notify <code>IObservers</code> of.
          */
         void notifyObservers( INotification* notification );
+        /**
+         * Notify the <code>IObservers</code> of a batch of <code>INotification</code>s.
+         *
+         * <P>
+         * The observer list is found once, then each observer in turn
+         * gets every body, so observers see the batch in observer order
+         * rather than body order. A <code>Mediator</code> gets the whole
+         * batch through <code>Mediator::handleNotifications</code>. Other observers
+         * are passed one notification whose body changes between calls,
+         * so like any sent notification it must not be kept.</P>
+         *
+         * @param notificationName the name of every notification in the batch
+         * @param bodies the body of each notification
+         * @param count the number of bodies
+         * @param notificationType the type of every notification in the batch
+         */
+        void notifyObserversBatch( int notificationName, void* const* bodies, size_t count, int notificationType );
 
         /**
          * Remove the observer for a given notifyContext from an observer list for a given Notification name.
          * <P>
+         * Kept for backward compatibility, this searches the list. Prefer
+         * removing by <code>Subscription</code>.</P>
          * @param notificationName which observer list to remove from
          * @param contextAddress remove the observer with this memory address as its notifyContext's address
          */
         void removeObserver( int notificationName, intptr_t contextAddress );
 
+        /**
+         * Remove the observer registration a <code>Subscription</code> refers to.
+         * <P>
+         * Takes constant time: the entry is marked removed where it is,
+         * and a list is only compacted once half of it is removed
+         * entries. Does nothing if the registration is already gone.</P>
+         * @param subscription the handle returned by <code>registerObserver</code>
+         */
+        void removeObserver( Subscription subscription );
+
         /**
          * Register an <code>IMediator</code> instance with the <code>View</code>.
          *
@@ -1578,203 +3198,1033 @@ namespace PureMVC {
         IMediator* retrieveMediator( std::string mediatorName );
 
         /**
-         * Remove an <code>IMediator</code> from the <code>View</code>.
+         * Remove an <code>IMediator</code> from the <code>View</code>.
+         *
+         * @param mediatorName name of the <code>IMediator</code> instance to be removed.
+         * @return the <code>IMediator</code> that was removed from the <code>View</code>
+         */
+        /**
+         * Remove an <code>IMediator</code> from the <code>View</code>.
+         *
+         * @param mediatorName name of the <code>IMediator</code> instance to be removed.
+         * @return the <code>IMediator</code> that was removed from the <code>View</code>
+         */
+        IMediator* removeMediator( std::string mediatorName );
+
+        /**
+         * Check if a Mediator is registered or not
+         *
+         * @param mediatorName
+         * @return whether a Mediator is registered with the given <code>mediatorName</code>.
+         */
+        bool hasMediator( std::string mediatorName );
+
+        /**
+         * Remove an IView instance
+         *
+         * @param multitonKey of IView instance to remove
+         */
+        static void removeView( std::string key );
+
+        /**
+         * Set the dense notification name limit.
+         *
+         * <P>
+         * Observer lists for notification names in <code>[0, limit)</code>
+         * are kept in a flat array indexed by name, so notifying them costs
+         * a single bounds check and pointer load. Names outside that range
+         * fall back to a sparse map. Small enums make good notification
+         * names; pass 0 to keep every list in the sparse map.</P>
+         * <P>
+         * Must not be called while a notification is being dispatched.</P>
+         *
+         * @param limit one past the largest notification name to index directly
+         */
+        void setDenseNameLimit( int limit );
+
+        /**
+         * Get the dense notification name limit.
+         *
+         * @return one past the largest notification name indexed directly
+         */
+        int getDenseNameLimit();
+
+        /**
+         * The default dense notification name limit.
+         */
+        static const int DEFAULT_DENSE_NAME_LIMIT = 1024;
+
+        virtual ~View();
+
+    protected:
+        /**
+         * A registered observer.
+         *
+         * <P>
+         * Removed observers are not erased right away, they are stamped
+         * with the epoch of their removal instead. Notifications that
+         * started before that epoch still reach them, later ones skip
+         * them, and the list is compacted once half of it is removed
+         * entries and no notification is walking it.</P>
+         */
+        struct ObserverEntry
+        {
+            Delegate delegate;
+            // 0 while registered, otherwise the epoch it was removed in
+            unsigned long removedAt;
+            // the subscription slot pointing back at this entry
+            unsigned int slot;
+        };
+        /**
+         * Where a live <code>Subscription</code>'s entry sits in its list.
+         */
+        struct SubscriptionSlot
+        {
+            // bumped every time the slot is freed
+            unsigned int generation;
+            size_t index;
+        };
+        /**
+         * An observer list for one notification name.
+         */
+        struct ObserverList
+        {
+            ObserverList() : dispatching(0), removed(0) {}
+            std::vector<ObserverEntry> entries;
+            // number of notifyObservers calls currently iterating this list
+            int dispatching;
+            // number of entries stamped as removed, waiting for compaction
+            size_t removed;
+        };
+
+        // Mapping of Mediator names to Mediator instances
+        std::map<std::string, IMediator*> mediatorMap;
+
+        // Mapping of Mediator names to their observer registrations
+        std::map<std::string, std::vector<Subscription> > mediatorSubscriptions;
+
+        // Subscription slots, indexed by Subscription::slot
+        std::vector<SubscriptionSlot> subscriptionSlots;
+
+        // Slots free for reuse
+        std::vector<unsigned int> freeSlots;
+
+        // Observer lists for notification names below denseNameLimit, indexed by name
+        std::vector<ObserverList*> denseObservers;
+
+        // Observer lists for typed Notification names, indexed from Notification::FIRST_TYPED_NAME
+        std::vector<ObserverList*> typedObservers;
+
+        // Observer lists for sparse Notification names
+        std::map<int, ObserverList> observerMap;
+
+        // One past the largest notification name held in denseObservers
+        int denseNameLimit;
+
+        // Bumped by every notification and every deferred removal
+        unsigned long epoch;
+
+    private:
+        bool existsObserversInterestedIn(int notificationName);
+        ObserverList* findObservers(int notificationName);
+        ObserverList& observersFor(int notificationName);
+        void compactObservers(int notificationName, ObserverList* observers);
+        void removeEntry(int notificationName, ObserverList* observers, size_t index);
+
+        // counts a notification walking an observer list, and compacts
+        // the list after the last one, even if an observer throws
+        class ObserverDispatch
+        {
+        public:
+            ObserverDispatch( View* view, int notificationName, ObserverList* observers );
+            ~ObserverDispatch();
+        private:
+            ObserverDispatch(ObserverDispatch const&);
+            ObserverDispatch& operator=(ObserverDispatch const&);
+            View* view;
+            int notificationName;
+            ObserverList* observers;
+        };
+        friend class ObserverDispatch;
+    };
+
+    //--------------------------------------
+    //  CommandFactory
+    //--------------------------------------
+    /**
+     * How long the <code>Controller</code> keeps <code>ICommand</code> instances.
+     */
+    class CommandLifetime
+    {
+    public:
+        enum lifetime
+        {
+            TRANSIENT,  // a new instance for every execution
+            POOLED,     // instances are recycled through a per-core pool
+            SINGLETON   // one instance per core handles every execution
+        };
+    };
+    /**
+     * Where the <code>Controller</code> executes <code>ICommand</code>s.
+     */
+    class CommandExecution
+    {
+    public:
+        enum execution
+        {
+            INLINE,     // on the thread that sent the notification
+            PARALLEL    // on the shared ThreadPool
+        };
+    };
+    /**
+     * The interface definition for an <code>ICommand</code> factory.
+     *
+     * <P>
+     * The <code>Controller</code> keeps one factory per registered
+     * <code>INotification</code> name and asks it for a ready-to-execute
+     * <code>ICommand</code> every time that notification is sent.</P>
+     */
+    class ICommandFactory
+    {
+    public:
+        /**
+         * Get an initialized <code>ICommand</code> to execute.
+         */
+        virtual ICommand* acquire() = 0;
+        /**
+         * Hand back an <code>ICommand</code> from <code>acquire</code> once it has executed.
+         */
+        virtual void release( ICommand* command ) = 0;
+        /**
+         * Whether the <code>ICommand</code>s should run on the <code>ThreadPool</code>.
+         */
+        virtual bool isParallel() = 0;
+        virtual ~ICommandFactory(){};
+    };
+    /**
+     * A <code>ICommandFactory</code> for <code>ICommand</code> class T.
+     *
+     * <P>
+     * TRANSIENT commands are constructed and deleted around every
+     * execution, which keeps stateful commands stateless. POOLED and
+     * SINGLETON commands skip that cost and so must not carry state from
+     * one execution to the next. A SINGLETON command may be re-entered
+     * if it sends a notification that executes it again; a POOLED one
+     * hands the nested execution another instance.</P>
+     *
+     * <P>
+     * PARALLEL factories are called from pool threads, so they lock
+     * around their pool and singleton. A PARALLEL SINGLETON command is
+     * executed by several threads at once and must be thread safe.</P>
+     */
+    template<class T>
+    class CommandFactory : public ICommandFactory
+    {
+    public:
+        /**
+         * Constructor.
+         *
+         * @param lifetime a <code>CommandLifetime::lifetime</code>
+         * @param multitonKey the key commands are initialized with
+         * @param execution a <code>CommandExecution::execution</code>
+         */
+        CommandFactory( int lifetime, std::string multitonKey, int execution = CommandExecution::INLINE )
+        {
+            this->lifetime = lifetime;
+            this->multitonKey = multitonKey;
+            this->parallel = execution == CommandExecution::PARALLEL;
+            this->singleton = (ICommand*) 0;
+        }
+        ~CommandFactory()
+        {
+            for(size_t i = 0; i < this->pool.size(); i++)
+                delete this->pool[i];
+            delete this->singleton;
+        }
+        ICommand* acquire()
+        {
+            if(this->lifetime == CommandLifetime::TRANSIENT)
+                return this->create();
+            if(this->parallel)
+                this->mutex.lock();
+            ICommand* command = this->singleton;
+            if(this->lifetime == CommandLifetime::POOLED && ! this->pool.empty())
+            {
+                command = this->pool.back();
+                this->pool.pop_back();
+            }
+            else if(command == (ICommand*) 0)
+            {
+                command = this->create();
+                if(this->lifetime == CommandLifetime::SINGLETON)
+                    this->singleton = command;
+            }
+            if(this->parallel)
+                this->mutex.unlock();
+            return command;
+        }
+        void release( ICommand* command )
+        {
+            if(this->lifetime == CommandLifetime::POOLED)
+            {
+                if(this->parallel)
+                    this->mutex.lock();
+                this->pool.push_back(command);
+                if(this->parallel)
+                    this->mutex.unlock();
+            }
+            else if(this->lifetime == CommandLifetime::TRANSIENT)
+                delete command;
+        }
+        bool isParallel()
+        {
+            return this->parallel;
+        }
+    private:
+        ICommand* create()
+        {
+            ICommand* command = new T();
+            command->initializeNotifier(this->multitonKey);
+            return command;
+        }
+        int lifetime;
+        bool parallel;
+        std::string multitonKey;
+        std::vector<ICommand*> pool;
+        ICommand* singleton;
+        // guards pool and singleton for PARALLEL factories
+        Mutex mutex;
+    };
+    //--------------------------------------
+    //  ThreadPool
+    //--------------------------------------
+    /**
+     * A work-stealing pool of worker threads.
+     *
+     * <P>
+     * Every worker has its own deque of tasks. A task submitted from a
+     * worker goes on that worker's deque, which it works through newest
+     * first; tasks from other threads are dealt round robin. A worker
+     * whose deque runs dry steals the oldest task from another worker's
+     * deque before going to sleep.</P>
+     *
+     * <P>
+     * The <code>Controller</code> runs PARALLEL commands on the shared pool.</P>
+     */
+    class ThreadPool
+    {
+    public:
+        /**
+         * A unit of work. The pool deletes it after <code>run</code> returns.
+         */
+        class Task
+        {
+        public:
+            virtual void run() = 0;
+            virtual ~Task(){};
+        };
+        /**
+         * Constructor.
+         *
+         * @param threads the number of worker threads, at least one
+         */
+        ThreadPool( unsigned int threads );
+        /**
+         * Wait for every task, then stop and join the workers.
+         */
+        ~ThreadPool();
+        /**
+         * Get the process-wide pool.
+         *
+         * <P>
+         * Created on first use with one worker per online processor and
+         * never destroyed.</P>
+         */
+        static ThreadPool* shared();
+        /**
+         * Queue a task. May be called from any thread, including from a task.
+         *
+         * @param task the task to run, owned by the pool from now on
+         */
+        void submit( Task* task );
+        /**
+         * Block until every submitted task has run.
+         *
+         * <P>
+         * Must not be called from a task, which would wait for itself.</P>
+         */
+        void wait();
+        /**
+         * Get the number of worker threads.
+         */
+        unsigned int size();
+    private:
+        ThreadPool(ThreadPool const&);
+        ThreadPool& operator=(ThreadPool const&);
+        struct Worker
+        {
+            ThreadPool* pool;
+            unsigned int index;
+            pthread_t thread;
+            Mutex mutex;
+            std::deque<Task*> tasks;
+        };
+        static void* work( void* worker );
+        Task* take( Worker* worker );
+        void finish();
+        std::vector<Worker*> workers;
+        // sleeping workers wait on available, wait() waits on idle
+        Mutex mutex;
+        pthread_cond_t available;
+        pthread_cond_t idle;
+        // tasks sitting in deques, may dip below zero while a task is in flight
+        long queued;
+        // tasks submitted and not yet finished
+        unsigned long pending;
+        // where the next task from outside the pool goes
+        unsigned int next;
+        bool stopping;
+    };
+    //--------------------------------------
+    //  Controller
+    //--------------------------------------
+    /**
+     * A Multiton <code>IController</code> implementation.
+     *
+     * <P>
+     * In PureMVC, the <code>Controller</code> class follows the
+     * 'Command and Controller' strategy, and assumes these
+     * responsibilities:
+     * <UL>
+     * <LI> Remembering which <code>ICommand</code>s
+     * are intended to handle which <code>INotifications</code>.</LI>
+     * <LI> Registering itself as an <code>IObserver</code> with
+     * the <code>View</code> for each <code>INotification</code>
+     * that it has an <code>ICommand</code> mapping for.</LI>
+     * <LI> Creating a new instance of the proper <code>ICommand</code>
+     * to handle a given <code>INotification</code> when notified by the <code>View</code>.</LI>
+     * <LI> Calling the <code>ICommand</code>'s <code>execute</code>
+     * method, passing in the <code>INotification</code>.</LI>
+     * </UL>
+     *
+     * <P>
+     * Your application must register <code>ICommands</code> with the
+     * Controller.
+     * <P>
+     * The simplest way is to subclass </code>Facade</code>,
+     * and use its <code>initializeController</code> method to add your
+     * registrations.
+     *
+     * @see View
+     * @see Observer
+     * @see Notification
+     * @see SimpleCommand
+     * @see MacroCommand
+     */
+    class Controller : public MultitonKeyHeir, public IController
+    {
+    public:
+        /**
+         * Constructor.
+         *
+         * <P>
+         * This <code>IController</code> implementation is a Multiton,
+         * so you should not call the constructor
+         * directly, but instead call the static Factory method,
+         * passing the unique key for this instance
+         * <code>Controller.getInstance( multitonKey )</code>
+         *
+         * @throws Error Error if instance for this Multiton key has already been constructed
+         *
+         */
+        Controller();
+        /**
+         * <code>Controller</code> Multiton Factory method.
+         *
+         * @return the Multiton instance of <code>Controller</code>
+         */
+        static IController* getInstance( std::string key );
+        /**
+         * If an <code>ICommand</code> has previously been registered
+         * to handle a the given <code>INotification</code>, then it is executed.
+         *
+         * <P>
+         * The command's factory is found with a single indexed load for
+         * dense notification names. PARALLEL commands are handed to the
+         * <code>ThreadPool</code> and may still be running when this returns.</P>
+         *
+         * @param note an <code>INotification</code>
+         */
+        void executeCommand( INotification* note );
+        /**
+         * Execute the <code>ICommand</code> registered for the given
+         * <code>INotification</code>.
+         *
+         * <P>
+         * Kept for backward compatibility, the <code>ICommand</code> class
+         * executed is the one given to <code>registerCommand</code>.</P>
+         *
+         * @param note an <code>INotification</code>
+         */
+        template<class T>
+        void executeCommand( INotification* note )
+        {
+            this->executeCommand(note);
+        };
+        /**
+         * Register a particular <code>ICommand</code> class as the handler
+         * for a particular <code>INotification</code>.
+         *
+         * <P>
+         * If an <code>ICommand</code> has already been registered to
+         * handle <code>INotification</code>s with this name, it is no longer
+         * used, the new <code>ICommand</code> is used instead.</P>
+         *
+         * The Observer for the new ICommand is only created if this the
+         * first time an ICommand has been regisered for this Notification name.
+         *
+         * <P>
+         * A PARALLEL command is executed on <code>ThreadPool::shared</code>
+         * and <code>executeCommand</code> returns without waiting for it.
+         * It gets a copy of the notification, but the body is only a
+         * pointer, so it must outlive the command, unless it is a shared
+         * payload (see <code>Notification::setSharedPayload</code>), which
+         * the copy keeps alive. The View is not thread
+         * safe, so a PARALLEL command should report back with
+         * <code>postNotification</code>, not <code>sendNotification</code>,
+         * and the pool must be waited for before the Core is removed. A
+         * removed PARALLEL command's factory is deleted once the pool has
+         * finished with it and the Controller next executes or removes a
+         * command.</P>
+         *
+         * @template commandClassRef the <code>Class</code> of the <code>ICommand</code>
+         * @param notificationName the name of the <code>INotification</code>
+         * @param lifetime a <code>CommandLifetime::lifetime</code>, TRANSIENT by default
+         * @param execution a <code>CommandExecution::execution</code>, INLINE by default
+         */
+        //void registerCommand( int notificationName, ICommand* commandClassRef );
+        template<class T>
+        void registerCommand(int notificationName, int lifetime = CommandLifetime::TRANSIENT, int execution = CommandExecution::INLINE)
+        {
+            // if we've already registered a command for this notification
+            // abort
+            if(this->hasCommand(notificationName))
+                return;
+            // remember how to make the command
+            this->addFactory(notificationName, new CommandFactory<T>(lifetime, this->getMultitonKey(), execution));
+        };
+        /**
+         * Check if a Command is registered for a given Notification
+         *
+         * @param notificationName
+         * @return whether a Command is currently registered for the given <code>notificationName</code>.
+         */
+        bool hasCommand( int notificationName );
+
+        /**
+         * Remove a previously registered <code>ICommand</code> to <code>INotification</code> mapping.
+         *
+         * @param notificationName the name of the <code>INotification</code> to remove the <code>ICommand</code> mapping for
+         */
+        void removeCommand( int notificationName );
+
+        /**
+         * Remove an IController instance
+         *
+         * @param multitonKey of IController instance to remove
+         */
+        static void removeController( std::string key );
+
+    protected:
+        /**
+         * Initialize the Multiton <code>Controller</code> instance.
+         *
+         * <P>Called automatically by the getInstance</P>
+         *
+         * @return void
+         */
+        void initializeController();
+
+        // Local reference to View
+        IView* view;
+
+        /**
+         * Register a factory for a notification name.
+         *
+         * <P>
+         * Called by <code>registerCommand</code>. Stores the factory and
+         * registers the controller as the name's observer with the
+         * <code>View</code>, so commands keep their place among the
+         * name's other observers.</P>
+         */
+        void addFactory( int notificationName, ICommandFactory* factory );
+
+        // Command factories for dense Notification names, indexed by name
+        std::vector<ICommandFactory*> denseCommands;
+
+        // Mapping of sparse Notification names to Command factories
+        std::map<int, ICommandFactory*> commandMap;
+
+        // The controller's observer registration for each Notification name
+        std::map<int, Subscription> commandSubscriptions;
+
+        // Number of commands currently executing
+        int executing;
+
+        // Number of PARALLEL commands queued or running on the pool
+        int executingInPool;
+
+        // Factories removed while a command was executing
+        std::vector<ICommandFactory*> retiredFactories;
+
+    private:
+        class CommandTask;
+        class ExecutionScope;
+        ICommandFactory* findFactory( int notificationName );
+        void deleteRetiredFactories();
+    };
+    //--------------------------------------
+    //  NotificationPool
+    //--------------------------------------
+    /**
+     * Recycles heap allocated <code>Notification</code>s.
+     *
+     * <P>
+     * Every thread keeps a free list of its own, so <code>acquire</code>
+     * and <code>release</code> on one thread take no locks and, once the
+     * list has warmed up, allocate nothing. A notification released on
+     * another thread, as when a posted notification is delivered by the
+     * Core's event loop, is pushed back onto its owner's lock-free return
+     * stack, which the owner empties into its free list the next time
+     * its own runs dry. When a thread exits its cache is kept for the
+     * next new thread, so notifications still out keep a home.</P>
+     *
+     * <P>
+     * <code>Facade::postNotification</code> takes its notifications from here.</P>
+     *
+     * @see Facade::postNotification
+     */
+    class NotificationPool
+    {
+    public:
+        /**
+         * The most free notifications a thread keeps, more are deleted.
+         */
+        static const unsigned long MAX_CACHED = 1024;
+        /**
+         * How the pool has been used, for sizing it.
+         */
+        struct Statistics
+        {
+            // threads that have had a cache
+            unsigned int threads;
+            // notifications the pool has allocated
+            unsigned long created;
+            // free notifications sitting in caches, not counting returns yet to be collected
+            unsigned long cached;
+            // the most notifications any one thread has had out at once
+            unsigned long highWater;
+        };
+        /**
+         * Get a notification, recycled if this thread has one to spare.
+         *
+         * @param notificationName the name of the notification
+         * @param body the body of the notification
+         * @param notificationType the type of the notification
+         * @return a notification to hand back to <code>release</code>
+         */
+        static Notification* acquire( int notificationName, void* body, int notificationType );
+        /**
+         * Hand back a notification. May be called from any thread.
+         *
+         * <P>
+         * Drops its payload straight away.</P>
+         *
+         * @param notification a notification from <code>acquire</code>
+         */
+        static void release( Notification* notification );
+        static Statistics statistics();
+    private:
+        struct Cache;
+        class Pooled;
+        static Cache* cache();
+        static void createKey();
+        static void orphan( void* cache );
+        // every cache ever made, those whose thread has exited, and their guard
+        static std::vector<Cache*>& caches();
+        static std::vector<Cache*>& orphans();
+        static Mutex& mutex();
+    };
+    //--------------------------------------
+    //  NotificationQueue
+    //--------------------------------------
+    /**
+     * Which posted <code>Notification</code>s a <code>NotificationQueue</code> merges.
+     */
+    class Coalescing
+    {
+    public:
+        enum mode
+        {
+            NONE,               // every post is delivered
+            BY_NAME,            // one per name, the latest body and type win
+            BY_NAME_AND_TYPE    // one per name and type, the latest body wins
+        };
+    };
+    /**
+     * A FIFO of posted <code>Notification</code>s.
+     *
+     * <P>
+     * Each <code>Facade</code> owns one. Any thread may push onto it;
+     * the thread pumping the Core pops from it. The queue owns the
+     * notifications in it, which come from <code>NotificationPool</code>,
+     * and with them their payloads. A body that
+     * is not a payload is only a pointer and must outlive delivery.</P>
+     *
+     * <P>
+     * Names can be set to coalesce: a post that matches a notification
+     * still waiting in the queue replaces that notification's body (and
+     * payload) instead of queueing another, so the observers run once per
+     * drain with the latest body, in the place of the first post.</P>
+     *
+     * @see Facade::postNotification
+     * @see Facade::pump
+     */
+    class NotificationQueue
+    {
+    public:
+        NotificationQueue();
+        ~NotificationQueue();
+        /**
+         * Queue a notification and wake a waiting consumer.
+         *
+         * @param notification a notification from <code>NotificationPool</code>, owned by the queue from now on
+         */
+        void push( Notification* notification );
+        /**
+         * Take the oldest notification.
+         *
+         * @return the notification, now owned by the caller, or null if the queue was empty
+         */
+        Notification* pop();
+        /**
+         * Get the number of queued notifications.
+         */
+        size_t size();
+        /**
+         * Block until a notification is queued or <code>wake</code> is called.
+         */
+        void wait();
+        /**
+         * Like <code>wait</code>, but give up after a while.
+         *
+         * @param milliseconds the longest to wait
+         */
+        void wait( unsigned long milliseconds );
+        /**
+         * Release every thread blocked in <code>wait</code>.
+         */
+        void wake();
+        /**
+         * Set how posts of a notification name are merged.
+         *
+         * @param notificationName the name of the notification
+         * @param mode a <code>Coalescing::mode</code>
+         */
+        void setCoalescing( int notificationName, int mode );
+    private:
+        NotificationQueue(NotificationQueue const&);
+        NotificationQueue& operator=(NotificationQueue const&);
+        typedef std::pair<int, int> CoalescingKey;
+        bool coalescingKey( Notification* notification, CoalescingKey& key );
+        std::deque<Notification*> notifications;
+        // the mode of every coalescing name
+        std::map<int, int> coalescing;
+        // where the queued notification for a coalescing key sits; a
+        // deque leaves its other elements in place as it grows and shrinks
+        std::map<CoalescingKey, Notification**> pending;
+        Mutex mutex;
+        pthread_cond_t posted;
+        bool woken;
+    };
+    //--------------------------------------
+    //  NotificationRing
+    //--------------------------------------
+    /**
+     * What a full <code>NotificationRing</code> does with another notification.
+     */
+    class Backpressure
+    {
+    public:
+        enum policy
+        {
+            BLOCK,          // the producer waits for room, the consumer is refused as with FAIL
+            DROP_OLDEST,    // the oldest notification waiting is dropped to make room
+            FAIL            // the new notification is refused
+        };
+    };
+    /**
+     * A bounded lock-free ring of <code>Notification</code>s.
+     *
+     * <P>
+     * Any number of threads push, one thread pops. Every cell carries a
+     * sequence number that says whose turn it is, so pushing and popping
+     * each take a single compare and swap and never a lock. When the
+     * ring is full a push follows the ring's <code>Backpressure</code>
+     * policy; a producer dropping the oldest notification takes it off
+     * the ring itself, which the cell sequence numbers make safe against
+     * the consumer doing the same. A blocked producer retries for a
+     * little while, then sleeps until a pop makes room; only then do
+     * the producer and the consumer take a lock.</P>
+     *
+     * <P>
+     * The ring owns the notifications in it, which come from
+     * <code>NotificationPool</code>.</P>
+     *
+     * @see Facade::postToInbox
+     */
+    class NotificationRing
+    {
+    public:
+        /**
+         * What the ring has been through, for sizing it.
+         */
+        struct Statistics
+        {
+            size_t capacity;
+            // notifications waiting now
+            size_t depth;
+            // the most notifications that have been waiting at once
+            size_t highWater;
+            // notifications dropped by DROP_OLDEST
+            unsigned long dropped;
+            // notifications refused by FAIL
+            unsigned long rejected;
+            // times a BLOCK producer had to sleep for room
+            unsigned long parked;
+        };
+        /**
+         * Constructor.
          *
-         * @param mediatorName name of the <code>IMediator</code> instance to be removed.
-         * @return the <code>IMediator</code> that was removed from the <code>View</code>
+         * @param capacity the most notifications waiting at once, rounded up to a power of two
+         * @param policy a <code>Backpressure::policy</code>
          */
+        NotificationRing( size_t capacity, int policy );
+        ~NotificationRing();
         /**
-         * Remove an <code>IMediator</code> from the <code>View</code>.
+         * Add a notification. May be called from any thread.
          *
-         * @param mediatorName name of the <code>IMediator</code> instance to be removed.
-         * @return the <code>IMediator</code> that was removed from the <code>View</code>
+         * <P>
+         * A BLOCK ring makes a producer wait for room, except for its
+         * consumer: nothing would ever make room for it, so its push is
+         * refused as if the ring were FAIL.</P>
+         *
+         * @param notification a notification from <code>NotificationPool</code>, owned by the ring if accepted
+         * @return false if the ring was full and refused it, which a FAIL ring or the consumer of a BLOCK ring does
          */
-        IMediator* removeMediator( std::string mediatorName );
-
+        bool push( Notification* notification );
         /**
-         * Check if a Mediator is registered or not
+         * Take the oldest notification. Only one thread may pop.
          *
-         * @param mediatorName
-         * @return whether a Mediator is registered with the given <code>mediatorName</code>.
+         * @return the notification, now owned by the caller, or null if the ring was empty
          */
-        bool hasMediator( std::string mediatorName );
-
+        Notification* pop();
         /**
-         * Remove an IView instance
+         * Make the calling thread the consumer, the one that pops.
+         */
+        void bindConsumer();
+        /**
+         * Get the number of waiting notifications.
+         */
+        size_t size();
+        /**
+         * Check whether there is a notification ready to pop.
          *
-         * @param multitonKey of IView instance to remove
+         * <P>
+         * Looks at the cell a push fills in last, so a consumer that
+         * announces it is going to sleep and then finds the ring empty
+         * knows the producer that fills it will see the announcement.</P>
          */
-        static void removeView( std::string key );
-
-    protected:
-        // Mapping of Mediator names to Mediator instances
-        std::map<std::string, IMediator*> mediatorMap;
-
-        // Mapping of Notification names to Observer lists
-        std::map<int, std::vector<IObserverRestricted*> > observerMap;
-
+        bool empty();
+        Statistics statistics();
     private:
-        bool existsObserversInterestedIn(int notificationName);
+        NotificationRing(NotificationRing const&);
+        NotificationRing& operator=(NotificationRing const&);
+        struct Cell
+        {
+            size_t sequence;
+            Notification* notification;
+        };
+        bool tryPush( Notification* notification );
+        void waitForRoom( Notification* notification );
+        Cell* cells;
+        size_t mask;
+        int policy;
+        // producers and the consumer each get a cache line of their own
+        char padding[64];
+        size_t enqueued;
+        char enqueuedPadding[64];
+        size_t dequeued;
+        // the thread that pops, which a full BLOCK ring mustn't make wait
+        void* consumer;
+        // BLOCK producers asleep, which a pop wakes
+        size_t sleeping;
+        char dequeuedPadding[64];
+        size_t highWater;
+        unsigned long dropped;
+        unsigned long rejected;
+        unsigned long parked;
+        Mutex roomMutex;
+        pthread_cond_t room;
     };
-
     //--------------------------------------
-    //  Controller
+    //  TimerWheel
     //--------------------------------------
     /**
-     * A Multiton <code>IController</code> implementation.
+     * A handle for a notification scheduled on a <code>TimerWheel</code>.
      *
      * <P>
-     * In PureMVC, the <code>Controller</code> class follows the
-     * 'Command and Controller' strategy, and assumes these
-     * responsibilities:
-     * <UL>
-     * <LI> Remembering which <code>ICommand</code>s
-     * are intended to handle which <code>INotifications</code>.</LI>
-     * <LI> Registering itself as an <code>IObserver</code> with
-     * the <code>View</code> for each <code>INotification</code>
-     * that it has an <code>ICommand</code> mapping for.</LI>
-     * <LI> Creating a new instance of the proper <code>ICommand</code>
-     * to handle a given <code>INotification</code> when notified by the <code>View</code>.</LI>
-     * <LI> Calling the <code>ICommand</code>'s <code>execute</code>
-     * method, passing in the <code>INotification</code>.</LI>
-     * </UL>
+     * Handed back to <code>cancel</code>. Like a <code>Subscription</code>
+     * the generation tells a stale handle, whose timer has fired or been
+     * cancelled, from a new timer in the same slot. A default constructed
+     * handle refers to nothing.</P>
+     */
+    class Timer
+    {
+    public:
+        Timer() : index(0), generation(0) {}
+        Timer(unsigned int index, unsigned int generation)
+            : index(index), generation(generation) {}
+        unsigned int index;
+        unsigned int generation;
+    };
+    /**
+     * A hierarchical timing wheel of scheduled notifications.
      *
      * <P>
-     * Your application must register <code>ICommands</code> with the
-     * Controller.
+     * Time moves in ticks of a millisecond. The wheel has
+     * <code>LEVELS</code> levels of <code>SLOTS</code> slots each, every
+     * level counting in ticks <code>SLOTS</code> times coarser than the
+     * one below. A timer goes in the slot for its expiry on the finest
+     * level that reaches that far, and drops a level each time the wheel
+     * turns past the slot it's in, so scheduling and cancelling are O(1)
+     * however many timers there are. Delays are capped at
+     * <code>SLOTS</code> to the power of <code>LEVELS</code> ticks, about
+     * 49 days.</P>
+     *
      * <P>
-     * The simplest way is to subclass </code>Facade</code>,
-     * and use its <code>initializeController</code> method to add your
-     * registrations.
+     * Expired timers post their notification onto a
+     * <code>NotificationQueue</code>. Every method may be called from any
+     * thread.</P>
      *
-     * @see View
-     * @see Observer
-     * @see Notification
-     * @see SimpleCommand
-     * @see MacroCommand
+     * @see Facade::sendNotificationAfter
      */
-    class Controller : public MultitonKeyHeir, public IController
+    class TimerWheel
     {
     public:
+        static const unsigned int LEVELS = 4;
+        static const unsigned int SLOT_BITS = 8;
+        static const unsigned int SLOTS = 1 << SLOT_BITS;
         /**
          * Constructor.
          *
-         * <P>
-         * This <code>IController</code> implementation is a Multiton,
-         * so you should not call the constructor
-         * directly, but instead call the static Factory method,
-         * passing the unique key for this instance
-         * <code>Controller.getInstance( multitonKey )</code>
-         *
-         * @throws Error Error if instance for this Multiton key has already been constructed
-         *
+         * @param start the tick the wheel starts at
          */
-        Controller();
+        TimerWheel( uint64_t start );
         /**
-         * <code>Controller</code> Multiton Factory method.
-         *
-         * @return the Multiton instance of <code>Controller</code>
+         * Get the current tick of the monotonic clock, in milliseconds.
          */
-        static IController* getInstance( std::string key );
+        static uint64_t now();
         /**
-         * If an <code>ICommand</code> has previously been registered
-         * to handle a the given <code>INotification</code>, then it is executed.
+         * Schedule a notification.
          *
-         * @param note an <code>INotification</code>
+         * @param now the current tick
+         * @param delay the ticks from now to post after, at the soonest the wheel's next tick
+         * @param period the ticks between posts of a periodic timer, 0 for a one shot timer
+         * @param notificationName the name of the notification
+         * @param body the body of the notification, which must outlive the timer
+         * @param notificationType the type of the notification
+         * @param sooner set if the timer is due before the tick <code>nextExpiry</code> last returned
+         * @return a handle to cancel the timer with
          */
-        template<class T>
-        void executeCommand( INotification* note )
-        {
-            // this is a special to c++ function,
-            // i feel like we're cheating here, but
-            // it's nice, but we had to get rid of
-            // executeCommand and registerCommand
-            // from IController for it... ...if you
-            // can think of a better way to keep this
-            // commands stateless through this execution
-            // then be my guest to revise this. - Schell
-            int name = note->getName();
-            // if this command isn't listed, abort
-            if(! this->hasCommand(name))
-                return;
-            // make a new instance of the command
-            ICommand* command = new T();
-            command->initializeNotifier(this->getMultitonKey());
-            command->execute(note);
-            // get rid of the evidence
-            delete command;
-        };
+        Timer schedule( uint64_t now, unsigned long delay, unsigned long period, int notificationName, void* body, int notificationType, bool& sooner );
         /**
-         * Register a particular <code>ICommand</code> class as the handler
-         * for a particular <code>INotification</code>.
-         *
-         * <P>
-         * If an <code>ICommand</code> has already been registered to
-         * handle <code>INotification</code>s with this name, it is no longer
-         * used, the new <code>ICommand</code> is used instead.</P>
-         *
-         * The Observer for the new ICommand is only created if this the
-         * first time an ICommand has been regisered for this Notification name.
+         * Cancel a timer.
          *
-         * @template commandClassRef the <code>Class</code> of the <code>ICommand</code>
-         * @param notificationName the name of the <code>INotification</code>
+         * @return false if the timer has already fired or been cancelled
          */
-        //void registerCommand( int notificationName, ICommand* commandClassRef );
-        template<class T>
-        void registerCommand(int notificationName)
-        {
-            // if we've already registered a command for this notification
-            // abort
-            if(this->hasCommand(notificationName))
-                return;
-            // create an observer for this command
-            Observer<Controller>* observer = new Observer<Controller>(&Controller::executeCommand<T>, this);
-            // register the observer with the view
-            this->view->registerObserver(notificationName, observer);
-            // give the commanMap something to chew on
-            commandMap[notificationName] = (T*) 0;
-        };
+        bool cancel( Timer timer );
         /**
-         * Check if a Command is registered for a given Notification
+         * Turn the wheel, posting the notifications of the timers that expire.
          *
-         * @param notificationName
-         * @return whether a Command is currently registered for the given <code>notificationName</code>.
+         * @param now the tick to advance to
+         * @param queue where expired timers post their notifications
+         * @return the number of notifications posted
          */
-        bool hasCommand( int notificationName );
-
+        unsigned int advance( uint64_t now, NotificationQueue& queue );
         /**
-         * Remove a previously registered <code>ICommand</code> to <code>INotification</code> mapping.
+         * Find a tick at or before the next expiry, to sleep until.
          *
-         * @param notificationName the name of the <code>INotification</code> to remove the <code>ICommand</code> mapping for
-         */
-        void removeCommand( int notificationName );
-
-        /**
-         * Remove an IController instance
+         * <P>
+         * Timers in the coarser levels are only known to the slot, so the
+         * tick may be early; advancing to it moves them closer.</P>
          *
-         * @param multitonKey of IController instance to remove
+         * @param expiry set to the tick
+         * @return false if there are no timers
          */
-        static void removeController( std::string key );
-
-    protected:
+        bool nextExpiry( uint64_t& expiry );
         /**
-         * Initialize the Multiton <code>Controller</code> instance.
-         *
-         * <P>Called automatically by the getInstance</P>
-         *
-         * @return void
+         * Get the number of scheduled timers.
          */
-        void initializeController();
-
-        // Local reference to View
-        IView* view;
-
-        // Mapping of Notification names to Command Class references
-        std::map<int, ICommand*> commandMap;
+        size_t size();
+    private:
+        TimerWheel(TimerWheel const&);
+        TimerWheel& operator=(TimerWheel const&);
+        struct Node
+        {
+            uint64_t expires;
+            unsigned long period;
+            int notificationName;
+            void* body;
+            int notificationType;
+            unsigned int generation;
+            // the slot the node is in, -1 when free
+            int bucket;
+            // the slot's list, linked by node index
+            int previous;
+            int next;
+        };
+        void insert( int index );
+        void unlink( int index );
+        int detach( int bucket );
+        std::vector<Node> nodes;
+        std::vector<int> freeNodes;
+        // the first node of each slot's list, level by level
+        int buckets[LEVELS * SLOTS];
+        // the number of timers on each level, empty levels are skipped over
+        size_t occupied[LEVELS];
+        // the last tick advanced to
+        uint64_t current;
+        // the tick nextExpiry last promised nothing expires before
+        uint64_t sleepingUntil;
+        size_t scheduled;
+        Mutex mutex;
     };
     //--------------------------------------
     //  Facade
     //--------------------------------------
+    /**
+     * What a <code>Facade</code> does with notifications sent while it is delivering one.
+     */
+    class DispatchMode
+    {
+    public:
+        enum mode
+        {
+            RECURSIVE,          // delivered there and then, on top of the sender's stack
+            RUN_TO_COMPLETION   // delivered in turn once the current notification is done
+        };
+    };
     /**
      * A base Multiton <code>IFacade</code> implementation.
      *
@@ -1805,16 +4255,25 @@ namespace PureMVC {
          *  @return the Multiton instance of the Facade
          */
         static Facade* getInstance(std::string);
+        /**
+         *  Find an initialized <code>Facade</code> by CoreId.
+         *  Never creates one and never locks.
+         *
+         *  @return the Facade, or null if there is none or it is still being initialized
+         */
+        static Facade* find( CoreId id );
         /**
          * Register an <code>ICommand</code> with the <code>Controller</code> by Notification name.
          *
          * @template commandClassRef a reference to the Class of the <code>ICommand</code>
          * @param notificationName the name of the <code>INotification</code> to associate the <code>ICommand</code> with
+         * @param lifetime a <code>CommandLifetime::lifetime</code>, TRANSIENT by default
+         * @param execution a <code>CommandExecution::execution</code>, INLINE by default
          */
         template<class T>
-        void registerCommand( int notificationName )
+        void registerCommand( int notificationName, int lifetime = CommandLifetime::TRANSIENT, int execution = CommandExecution::INLINE )
         {
-            dynamic_cast<Controller*>(this->controller)->registerCommand<T>(notificationName);
+            dynamic_cast<Controller*>(this->controller)->registerCommand<T>(notificationName, lifetime, execution);
         };
 
         /**
@@ -1839,13 +4298,42 @@ namespace PureMVC {
          * @param proxy the <code>IProxy</code> instance to be registered with the <code>Model</code>.
          */
         void registerProxy ( IProxy* proxy );
+        /**
+         * Register an <code>IProxy</code> with the <code>Model</code>, to be constructed when it is first retrieved.
+         *
+         * @param proxyName the name to register the <code>IProxy</code> as.
+         * @param factory constructs the <code>IProxy</code>, and is then deleted by the <code>Model</code>.
+         * @see Model::registerProxyFactory
+         */
+        void registerProxyFactory( std::string proxyName, IProxyFactory* factory );
+        /**
+         * Register an <code>IProxy</code> of class T with the <code>Model</code>, to be constructed, with its name, when it is first retrieved.
+         */
+        template<class T>
+        void registerProxyFactory( std::string proxyName )
+        {
+            this->registerProxyFactory(proxyName, new ProxyFactory<T>());
+        }
+        /**
+         * Register several <code>IProxy</code> instances with the <code>Model</code>, running their <code>onRegister</code> methods concurrently.
+         *
+         * <P>
+         * The <code>onRegister</code> methods run on pool threads, so they
+         * must <code>postNotification</code> rather than
+         * <code>sendNotification</code>, and must not register or remove
+         * proxies.</P>
+         *
+         * @param registrations the proxies, and the proxies each of them depends on.
+         * @see Model::registerProxies
+         */
+        void registerProxies( const std::vector<ProxyRegistration>& registrations );
         /**
          * Retrieve an <code>IProxy</code> from the <code>Model</code> by name.
          *
          * @param proxyName the name of the proxy to be retrieved.
          * @return the <code>IProxy</code> instance previously registered with the given <code>proxyName</code>.
          */
-        IProxy* retrieveProxy ( std::string proxyName );
+        IProxy* retrieveProxy ( StringRef proxyName );
 
         /**
          * Remove an <code>IProxy</code> from the <code>Model</code> by name.
@@ -1853,7 +4341,7 @@ namespace PureMVC {
          * @param proxyName the <code>IProxy</code> to remove from the <code>Model</code>.
          * @return the <code>IProxy</code> that was removed from the <code>Model</code>
          */
-        IProxy* removeProxy ( std::string proxyName );
+        IProxy* removeProxy ( StringRef proxyName );
 
         /**
          * Check if a Proxy is registered
@@ -1861,7 +4349,7 @@ namespace PureMVC {
          * @param proxyName
          * @return whether a Proxy is currently registered with the given <code>proxyName</code>.
          */
-        bool hasProxy( std::string proxyName );
+        bool hasProxy( StringRef proxyName );
 
         /**
          * Register a <code>IMediator</code> with the <code>View</code>.
@@ -1900,7 +4388,11 @@ namespace PureMVC {
          *
          * <P>
          * Keeps us from having to construct new notification
-         * instances in our implementation code.
+         * instances in our implementation code.</P>
+         * <P>
+         * The notification is built on the stack and does not touch the
+         * heap. It is only valid while observers are being notified, so
+         * an observer that needs it afterwards must copy it.</P>
          * @param notificationName the name of the notiification to send
          * @param body the body of the notification (optional)
          * @param type the type of the notification (optional)
@@ -1909,6 +4401,248 @@ namespace PureMVC {
         void sendNotification( int notificationName, void* body );
         void sendNotification( int notificationName, int notificationType );
         void sendNotification( int notificationName );
+        /**
+         * Send a batch of <code>INotification</code>s sharing a name and type.
+         *
+         * <P>
+         * Cheaper than a <code>sendNotification</code> per body for bulk
+         * traffic, as the observers are looked up once for the batch.
+         * Each observer handles every body before the next observer
+         * sees any of them.</P>
+         * @param notificationName the name of every notification in the batch
+         * @param bodies the body of each notification, borrowed for the duration of the call
+         * @param count the number of bodies
+         * @param type the type of every notification in the batch (optional)
+         * @see View::notifyObserversBatch
+         */
+        void sendNotifications( int notificationName, void* const* bodies, size_t count, int notificationType );
+        void sendNotifications( int notificationName, void* const* bodies, size_t count );
+        /**
+         * Create and send a <code>TypedNotification</code>.
+         *
+         * <P>
+         * <code>sendNotification<SetTitle>(title)</code>. The payload
+         * type has to be named, which keeps calls like
+         * <code>sendNotification(n_name::STARTUP)</code> on the int
+         * overload. Like the untyped overloads nothing is allocated.</P>
+         * @param payload the payload, borrowed for the duration of the call
+         */
+        template<class P>
+        void sendNotification( const typename Named<P>::type& payload )
+        {
+            TypedNotification<P> notification(payload);
+            this->notifyObservers(&notification);
+        }
+        /**
+         * Register a payload handler for <code>TypedNotification</code>s of P.
+         *
+         * @param context the interested object
+         * @return a handle for <code>unsubscribe</code>
+         * @see View::subscribe
+         */
+        template<class P, class T, void (T::*method)(const P&)>
+        Subscription subscribe( T* context )
+        {
+            return this->view->registerObserver(TypedNotification<P>::notificationName(), Delegate::bindPayload<P, T, method>(context));
+        }
+        /**
+         * Remove a registration made with <code>subscribe</code>.
+         *
+         * @param subscription the handle <code>subscribe</code> returned
+         */
+        void unsubscribe( Subscription subscription );
+        /**
+         * Create and post an <code>INotification</code>.
+         *
+         * <P>
+         * The notification is queued and this method returns at once.
+         * It is delivered to observers, in the order it was posted, by the
+         * next call to <code>pump</code> or by the thread running
+         * <code>runEventLoop</code>. Delivery is run-to-completion: every
+         * observer of one posted notification has returned before the next
+         * one is delivered, and notifications posted from an observer wait
+         * their turn instead of growing the stack.</P>
+         * <P>
+         * May be called from any thread.</P>
+         * @param notificationName the name of the notiification to post
+         * @param body the body of the notification (optional)
+         * @param type the type of the notification (optional)
+         */
+        void postNotification( int notificationName, void* body, int notificationType );
+        void postNotification( int notificationName, void* body );
+        void postNotification( int notificationName, int notificationType );
+        void postNotification( int notificationName );
+        /**
+         * Create and post an <code>INotification</code> that owns its body.
+         *
+         * <P>
+         * The payload's value is transferred to the queued notification
+         * without copying a heap or shared value, and destroyed once
+         * every observer has seen it. Use this rather than a pointer to a
+         * local when the sender may return, or live on another thread,
+         * before the notification is delivered.</P>
+         * @param notificationName the name of the notiification to post
+         * @param payload the body, emptied by the call
+         * @param type the type of the notification (optional)
+         */
+        void postNotification( int notificationName, Payload& payload, int notificationType );
+        void postNotification( int notificationName, Payload& payload );
+        /**
+         * Deliver posted notifications.
+         *
+         * <P>
+         * Delivers the notifications that were queued when pump was
+         * called, after posting those of any timers that have expired.
+         * Notifications posted while pumping are left for the
+         * next call, so an observer that keeps re-posting cannot keep
+         * pump from returning.</P>
+         *
+         * @return the number of notifications delivered
+         */
+        unsigned int pump();
+        /**
+         * Deliver posted notifications until <code>stopEventLoop</code> is called.
+         *
+         * <P>
+         * Blocks the calling thread, sleeping while the queue is empty
+         * until the next timer is due.
+         * Run it on a dedicated thread to decouple producers from
+         * observers. Only one thread should pump a Core at a time.</P>
+         */
+        void runEventLoop();
+        /**
+         * Make <code>runEventLoop</code> return.
+         *
+         * <P>
+         * May be called from any thread, including from an observer
+         * running on the loop. The loop returns once its current pump is
+         * done, leaving anything posted after that for a later
+         * <code>pump</code>.</P>
+         */
+        void stopEventLoop();
+        /**
+         * Merge posted notifications of a name until they are delivered.
+         *
+         * <P>
+         * For frame based consumers that are posted the same notification
+         * many times between pumps, like a redisplay request from every
+         * input event. With a mode other than <code>NONE</code> a post of
+         * notificationName replaces the matching notification still in the
+         * queue, so the observers run once per pump with the latest body.
+         * <code>sendNotification</code> is not affected.</P>
+         *
+         * @param notificationName the name of the notification
+         * @param mode a <code>Coalescing::mode</code>
+         */
+        void setCoalescing( int notificationName, int mode );
+        /**
+         * Post a notification after a delay.
+         *
+         * <P>
+         * The notification is queued when the delay is up and delivered
+         * like a posted one, by the next <code>pump</code> or by the event
+         * loop, which sleeps until the next timer is due rather than
+         * polling. Nothing is delivered while the Core isn't pumped.
+         * Scheduling and cancelling take constant time, see
+         * <code>TimerWheel</code>.</P>
+         *
+         * @param milliseconds the delay
+         * @param notificationName the name of the notification
+         * @param body the body of the notification, which must outlive the timer (optional)
+         * @param notificationType the type of the notification (optional)
+         * @return a handle for <code>cancelTimer</code>
+         */
+        Timer sendNotificationAfter( unsigned long milliseconds, int notificationName, void* body = 0, int notificationType = 0 );
+        /**
+         * Post a notification every so often, starting one period from now.
+         *
+         * <P>
+         * The next post is scheduled a period after the last was due, or
+         * after it was pumped if the Core fell behind.</P>
+         *
+         * @param milliseconds the period, at least a millisecond
+         * @param notificationName the name of the notification
+         * @param body the body of the notification, which must outlive the timer (optional)
+         * @param notificationType the type of the notification (optional)
+         * @return a handle for <code>cancelTimer</code>
+         */
+        Timer sendNotificationEvery( unsigned long milliseconds, int notificationName, void* body = 0, int notificationType = 0 );
+        /**
+         * Stop a timer from posting again.
+         *
+         * @param timer a handle from <code>sendNotificationAfter</code> or <code>sendNotificationEvery</code>
+         * @return false if the timer had already fired or been cancelled
+         */
+        bool cancelTimer( Timer timer );
+        /**
+         * Set how notifications sent by observers are delivered.
+         *
+         * <P>
+         * By default a notification sent from an observer is delivered
+         * before <code>sendNotification</code> returns, so a chain of
+         * observers that keep sending nests deeper and deeper. In
+         * RUN_TO_COMPLETION mode a send made while a notification is
+         * being delivered is queued instead, and the queue is worked
+         * through, first in first out, after the outermost notification
+         * has been delivered. Every observer then runs to completion
+         * before the next one starts, and the stack stays as deep as one
+         * delivery whatever the chain.</P>
+         *
+         * <P>
+         * The notification is copied when it is queued, but its body is
+         * only a pointer and has to outlive the sender's handler.
+         * Payloads, including those of typed notifications, are copied.</P>
+         *
+         * @param mode a <code>DispatchMode::mode</code>
+         */
+        void setDispatchMode( int mode );
+        /**
+         * Set the size and backpressure policy of the Core's inbox.
+         *
+         * <P>
+         * The inbox is a lock-free ring for notifications from other
+         * threads, 1024 notifications long and blocking by default. Set
+         * it up before any thread posts to it, from
+         * <code>initializeFacade</code> for example; anything already
+         * waiting in the old inbox is moved across.</P>
+         *
+         * @param capacity the most notifications waiting at once, rounded up to a power of two
+         * @param policy a <code>Backpressure::policy</code>
+         */
+        void setInbox( size_t capacity, int policy );
+        /**
+         * Post a notification to the Core's inbox.
+         *
+         * <P>
+         * Like <code>postNotification</code>, but producers never take a
+         * lock, and the inbox is bounded: when it is full a BLOCK inbox
+         * makes the caller wait for room, a DROP_OLDEST inbox drops the
+         * oldest waiting notification and a FAIL inbox refuses this one.
+         * A BLOCK inbox refuses the thread that pumps the Core instead,
+         * since that thread would be waiting for itself.
+         * Meant for worker threads reporting to the Core; notifications
+         * are delivered by <code>pump</code> and the event loop, after
+         * those posted with <code>postNotification</code>.</P>
+         *
+         * @param notificationName the name of the notification
+         * @param body the body of the notification (optional)
+         * @param notificationType the type of the notification (optional)
+         * @return false if the inbox refused the notification
+         */
+        bool postToInbox( int notificationName, void* body = 0, int notificationType = 0 );
+        /**
+         * Post a notification that owns its body to the Core's inbox.
+         *
+         * @param notificationName the name of the notification
+         * @param payload the body, emptied by the call even if the notification is refused
+         * @param notificationType the type of the notification (optional)
+         * @return false if the inbox refused the notification
+         */
+        bool postToInbox( int notificationName, Payload& payload, int notificationType = 0 );
+        /**
+         * Get the counters of the Core's inbox.
+         */
+        NotificationRing::Statistics inboxStatistics();
         /**
          * Notify <code>Observer</code>s.
          * <P>
@@ -1951,6 +4685,16 @@ namespace PureMVC {
          * @param multitonKey of the Core to remove
          */
         static void removeCore( std::string key );
+
+        /**
+         * Get the Core generation.
+         * <P>
+         * The generation changes every time a Core is removed, which
+         * tells Notifiers that their cached facade may be gone.</P>
+         *
+         * @return the current Core generation
+         */
+        static unsigned long getCoreGeneration();
     protected:
         /**
          * Initialize the Multiton <code>Facade</code> instance.
@@ -2033,6 +4777,30 @@ namespace PureMVC {
         IController* controller;
         IModel* model;
         IView* view;
+
+    private:
+        // posted notifications waiting to be pumped
+        NotificationQueue queue;
+        // timers waiting to post
+        TimerWheel timers;
+        // notifications from other threads, set by the event loop
+        // while it sleeps so that producers know to wake it
+        NotificationRing* inbox;
+        int sleeping;
+        // set once getInstance has initialized the core
+        bool initialized;
+        // notifications sent during a RUN_TO_COMPLETION delivery
+        int dispatchMode;
+        bool dispatching;
+        std::deque<Notification*> deferred;
+        void defer( INotification* notification );
+        void deliverDeferred();
+        void sleep( unsigned long milliseconds );
+        bool deliverToInbox( Notification* notification );
+        // cleared by stopEventLoop
+        bool looping;
+        // bumped by removeCore
+        static unsigned long coreGeneration;
     };
 
 }
@@ -10,7 +10,12 @@
 
 #include <iostream>
 #include <vector>
+#include <new>
+#include <cstdlib>
+#include <cstdio>
 #include <stdint.h>
+#include <unistd.h>
+#include <sched.h>
 
 // cxxtest
 #include <cxxtest/TestSuite.h>
@@ -19,9 +24,90 @@
 
 using namespace PureMVC;
 
+//--------------------------------------
+//  Allocation counting
+//--------------------------------------
+// counts every call to the global operator new, so tests can assert
+// that a code path stays off the heap
+static size_t allocations = 0;
+#if __cplusplus >= 201103L
+void* operator new(std::size_t size)
+#else
+void* operator new(std::size_t size) throw(std::bad_alloc)
+#endif
+{
+    __atomic_add_fetch(&allocations, 1, __ATOMIC_RELAXED);
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if(memory == 0)
+        throw std::bad_alloc();
+    return memory;
+}
+#if __cplusplus >= 201103L
+void operator delete(void* memory) noexcept
+#else
+void operator delete(void* memory) throw()
+#endif
+{
+    std::free(memory);
+}
 //--------------------------------------
 //  Patterns
 //--------------------------------------
+// creates and looks up a spread of multitons, from several threads at once
+static void* createMultitons(void* offset)
+{
+    for(int round = 0; round < 50; round++)
+    {
+        for(CoreId i = 0; i < 64; i++)
+        {
+            CoreId id = MultitonKey::intern("concurrent");
+            long* inst = Multiton<long>::instance(id + 1 + (i + *(int*) offset) % 64);
+            if(inst != Multiton<long>::find(id + 1 + (i + *(int*) offset) % 64))
+                return offset;
+        }
+    }
+    return 0;
+}
+// gets the actors of a spread of new cores, each thread in its own order,
+// and checks that none of them is handed out before it is set up
+struct CoreCreation
+{
+    int order;
+    IFacade* facades[16];
+    IView* views[16];
+    IController* controllers[16];
+    bool ready;
+};
+static void* createCores(void* argument)
+{
+    CoreCreation* creation = (CoreCreation*) argument;
+    for(int i = 0; i < 16; i++)
+    {
+        char key[32];
+        sprintf(key, "racedCore%d", (i + creation->order * 5) % 16);
+        int core = (i + creation->order * 5) % 16;
+        for(int actor = 0; actor < 3; actor++)
+        {
+            switch((actor + creation->order) % 3)
+            {
+            case 0:
+                creation->facades[core] = Facade::getInstance(key);
+                creation->ready = creation->ready && creation->facades[core]->getMultitonKey() == key
+                    && ! creation->facades[core]->hasProxy("missing");
+                break;
+            case 1:
+                creation->views[core] = View::getInstance(key);
+                creation->ready = creation->ready && creation->views[core]->getMultitonKey() == key;
+                break;
+            case 2:
+                creation->controllers[core] = Controller::getInstance(key);
+                creation->ready = creation->ready && creation->controllers[core]->getMultitonKey() == key;
+                break;
+            }
+        }
+    }
+    return 0;
+}
 class MultitonTestSuite : public CxxTest::TestSuite
 {
 public:
@@ -44,10 +130,100 @@ public:
         Multiton<int>::instance("new instance");
         TS_ASSERT_EQUALS(Multiton<int>::size(), (size_t) 2);
     }
+    void testCoreIdsIndexTheSameInstances()
+    {
+        CoreId id = MultitonKey::intern("interned instance");
+        TS_ASSERT_EQUALS(MultitonKey::intern("interned instance"), id);
+        TS_ASSERT_EQUALS(MultitonKey::name(id), "interned instance");
+        TS_ASSERT(! Multiton<int>::exists(id));
+        TS_ASSERT(Multiton<int>::find(id) == (int*) 0);
+        int* byId = Multiton<int>::instance(id);
+        TS_ASSERT_EQUALS(&*byId, &*Multiton<int>::instance("interned instance"));
+        TS_ASSERT(Multiton<int>::exists("interned instance"));
+        Multiton<int>::erase(id);
+        TS_ASSERT(! Multiton<int>::exists("interned instance"));
+        // probing an unknown key does not intern it
+        CoreId unknown;
+        TS_ASSERT(! Multiton<int>::exists("never interned"));
+        TS_ASSERT(! MultitonKey::lookup("never interned", unknown));
+    }
+    void testConcurrentCreationYieldsOneInstancePerKey()
+    {
+        pthread_t threads[8];
+        int offsets[8];
+        for(int i = 0; i < 8; i++)
+        {
+            offsets[i] = i * 8;
+            pthread_create(&threads[i], NULL, createMultitons, &offsets[i]);
+        }
+        for(int i = 0; i < 8; i++)
+        {
+            void* failed;
+            pthread_join(threads[i], &failed);
+            TS_ASSERT(failed == 0);
+        }
+        TS_ASSERT_EQUALS(Multiton<long>::size(), (size_t) 64);
+    }
+    void testConcurrentCoresAreSetUpBeforeTheyAreShared()
+    {
+        const int threads = 6;
+        CoreCreation creations[threads];
+        pthread_t ids[threads];
+        for(int i = 0; i < threads; i++)
+        {
+            creations[i].order = i;
+            creations[i].ready = true;
+            pthread_create(&ids[i], NULL, createCores, &creations[i]);
+        }
+        for(int i = 0; i < threads; i++)
+            pthread_join(ids[i], NULL);
+        bool shared = true;
+        for(int i = 0; i < threads; i++)
+        {
+            TS_ASSERT(creations[i].ready);
+            for(int core = 0; core < 16; core++)
+            {
+                shared = shared && creations[i].facades[core] == creations[0].facades[core];
+                shared = shared && creations[i].views[core] == creations[0].views[core];
+                shared = shared && creations[i].controllers[core] == creations[0].controllers[core];
+            }
+        }
+        TS_ASSERT(shared);
+        for(int core = 0; core < 16; core++)
+        {
+            char key[32];
+            sprintf(key, "racedCore%d", core);
+            Facade::removeCore(key);
+        }
+    }
 };
 //--------------------------------------
 //  Notification
 //--------------------------------------
+// counts live instances, Size pads it out of a Payload's inline storage
+template<int Size>
+struct Tracked
+{
+    Tracked(int value) : value(value)
+    {
+        Tracked::live++;
+    }
+    Tracked(Tracked const& other) : value(other.value)
+    {
+        Tracked::live++;
+    }
+    ~Tracked()
+    {
+        Tracked::live--;
+    }
+    int value;
+    char padding[Size];
+    static int live;
+};
+template<int Size>
+int Tracked<Size>::live = 0;
+typedef Tracked<4> SmallTracked;
+typedef Tracked<128> LargeTracked;
 class NotificationTestSuite : public CxxTest::TestSuite
 {
 public:
@@ -65,6 +241,73 @@ public:
         int castBody = *((int*) this->notification->getBody());
         TS_ASSERT_EQUALS(castBody, this->body);
     }
+    void testPayloadsAreDestroyedExactlyOnce()
+    {
+        SmallTracked::live = 0;
+        LargeTracked::live = 0;
+        {
+            Payload small;
+            small.set(SmallTracked(1));
+            Payload large;
+            large.set(LargeTracked(2));
+            TS_ASSERT_EQUALS(SmallTracked::live, 1);
+            TS_ASSERT_EQUALS(LargeTracked::live, 1);
+            TS_ASSERT(small.get<LargeTracked>() == (LargeTracked*) 0);
+            // transferring moves the value, it is not duplicated
+            Notification note(this->name);
+            note.takePayload(small);
+            TS_ASSERT(small.empty());
+            TS_ASSERT_EQUALS(SmallTracked::live, 1);
+            TS_ASSERT_EQUALS(((SmallTracked*) note.getBody())->value, 1);
+            LargeTracked* heap = large.get<LargeTracked>();
+            Payload moved;
+            moved.transfer(large);
+            TS_ASSERT(moved.get<LargeTracked>() == heap);
+            TS_ASSERT_EQUALS(LargeTracked::live, 1);
+            // replacing the body drops the payload
+            note.setBody(&this->body);
+            TS_ASSERT(! note.hasPayload());
+            TS_ASSERT_EQUALS(SmallTracked::live, 0);
+        }
+        TS_ASSERT_EQUALS(LargeTracked::live, 0);
+        {
+            Notification note(this->name);
+            note.setSharedPayload(SmallTracked(3));
+            Notification copy(note);
+            TS_ASSERT_EQUALS(copy.getBody(), note.getBody());
+            TS_ASSERT_EQUALS(copy.getPayloadAs<SmallTracked>()->value, 3);
+            note.setBody(&this->body);
+            TS_ASSERT_EQUALS(SmallTracked::live, 1);
+        }
+        TS_ASSERT_EQUALS(SmallTracked::live, 0);
+    }
+    void testCopiesOwnTheirPayloads()
+    {
+        SmallTracked::live = 0;
+        LargeTracked::live = 0;
+        Notification* small = new Notification(this->name);
+        small->setPayload(SmallTracked(4));
+        Notification* large = new Notification(this->name);
+        large->setPayload(LargeTracked(5));
+        Notification smallCopy(*small);
+        Notification largeCopy(this->name);
+        largeCopy = *large;
+        TS_ASSERT_DIFFERS(smallCopy.getBody(), small->getBody());
+        TS_ASSERT_EQUALS(SmallTracked::live, 2);
+        TS_ASSERT_EQUALS(LargeTracked::live, 2);
+        // the copies' bodies outlive the originals
+        delete small;
+        large->setBody(&this->body);
+        TS_ASSERT_EQUALS(((SmallTracked*) smallCopy.getBody())->value, 4);
+        TS_ASSERT_EQUALS(largeCopy.getPayloadAs<LargeTracked>()->value, 5);
+        TS_ASSERT_EQUALS(SmallTracked::live, 1);
+        TS_ASSERT_EQUALS(LargeTracked::live, 1);
+        delete large;
+        smallCopy.setBody(&this->body);
+        largeCopy.setBody(&this->body);
+        TS_ASSERT_EQUALS(SmallTracked::live, 0);
+        TS_ASSERT_EQUALS(LargeTracked::live, 0);
+    }
 private:
     Notification* notification;
     int name;
@@ -84,6 +327,153 @@ public:
     static int executions;
 };
 int SimpleTestClass::executions = 0;
+// counts how many instances the Controller constructs
+class CountedCommand : public SimpleCommand
+{
+public:
+    CountedCommand()
+    {
+        CountedCommand::constructions++;
+    }
+    void execute(INotification* notification)
+    {
+        CountedCommand::executions++;
+    }
+    static int constructions;
+    static int executions;
+};
+int CountedCommand::constructions = 0;
+int CountedCommand::executions = 0;
+// counts executions from pool threads and remembers the last body
+class ParallelCommand : public SimpleCommand
+{
+public:
+    void execute(INotification* notification)
+    {
+        __atomic_add_fetch(&ParallelCommand::executions, 1, __ATOMIC_RELAXED);
+        if(pthread_equal(pthread_self(), ParallelCommand::sender))
+            __atomic_add_fetch(&ParallelCommand::onSender, 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&ParallelCommand::lastBody, notification->getBody(), __ATOMIC_RELAXED);
+    }
+    static int executions;
+    static int onSender;
+    static void* lastBody;
+    static pthread_t sender;
+};
+int ParallelCommand::executions = 0;
+int ParallelCommand::onSender = 0;
+void* ParallelCommand::lastBody = 0;
+pthread_t ParallelCommand::sender;
+// posts its own notification again until it has run three times
+class RepostingCommand : public SimpleCommand
+{
+public:
+    void execute(INotification* notification)
+    {
+        RepostingCommand::executions++;
+        if(RepostingCommand::executions < 3)
+            this->postNotification(notification->getName());
+    }
+    static int executions;
+};
+int RepostingCommand::executions = 0;
+// remembers the value of the last payload it saw
+class PayloadCommand : public SimpleCommand
+{
+public:
+    void execute(INotification* notification)
+    {
+        PayloadCommand::lastValue = ((LargeTracked*) notification->getBody())->value;
+        PayloadCommand::liveDuringExecute = LargeTracked::live;
+    }
+    static int lastValue;
+    static int liveDuringExecute;
+};
+int PayloadCommand::lastValue = 0;
+int PayloadCommand::liveDuringExecute = 0;
+// remembers the body and type of the last notification and counts them
+class LastBodyCommand : public SimpleCommand
+{
+public:
+    void execute(INotification* notification)
+    {
+        LastBodyCommand::executions++;
+        LastBodyCommand::lastBody = notification->getBody();
+        LastBodyCommand::lastType = notification->getType();
+    }
+    static int executions;
+    static void* lastBody;
+    static int lastType;
+};
+int LastBodyCommand::executions = 0;
+void* LastBodyCommand::lastBody = 0;
+int LastBodyCommand::lastType = 0;
+// sends the next name on until the chain is done, tracking how deep it nests
+class ChainingCommand : public SimpleCommand
+{
+public:
+    void execute(INotification* notification)
+    {
+        ChainingCommand::depth++;
+        if(ChainingCommand::depth > ChainingCommand::maxDepth)
+            ChainingCommand::maxDepth = ChainingCommand::depth;
+        ChainingCommand::order.push_back(notification->getType());
+        if(notification->getType() < ChainingCommand::length)
+            this->sendNotification(notification->getName(), 0, notification->getType() + 1);
+        ChainingCommand::order.push_back(-notification->getType());
+        ChainingCommand::depth--;
+    }
+    static int length;
+    static int depth;
+    static int maxDepth;
+    static std::vector<int> order;
+};
+int ChainingCommand::length = 0;
+int ChainingCommand::depth = 0;
+int ChainingCommand::maxDepth = 0;
+std::vector<int> ChainingCommand::order;
+// throws the type of the notification it is given
+class ThrowingCommand : public SimpleCommand
+{
+public:
+    ThrowingCommand()
+    {
+        ThrowingCommand::live++;
+    }
+    ~ThrowingCommand()
+    {
+        ThrowingCommand::live--;
+    }
+    void execute(INotification* notification)
+    {
+        throw notification->getType();
+    }
+    static int live;
+};
+int ThrowingCommand::live = 0;
+// posts its notification to the inbox twice more, counting refusals
+class InboxRepostingCommand : public SimpleCommand
+{
+public:
+    void execute(INotification* notification)
+    {
+        Facade* facade = dynamic_cast<Facade*>(this->getFacade());
+        for(int i = 0; i < 2; i++)
+            if(! facade->postToInbox(notification->getName()))
+                InboxRepostingCommand::refused++;
+    }
+    static int refused;
+};
+int InboxRepostingCommand::refused = 0;
+// stops the event loop of the core it runs in
+class StopLoopCommand : public SimpleCommand
+{
+public:
+    void execute(INotification* notification)
+    {
+        dynamic_cast<Facade*>(this->getFacade())->stopEventLoop();
+    }
+};
 //--------------------------------------
 //  MacroCommand
 //--------------------------------------
@@ -128,6 +518,30 @@ private:
 //--------------------------------------
 //  Notifier
 //--------------------------------------
+// a notifier whose facade can be asked for from outside
+class FacadeReader : public Notifier
+{
+public:
+    IFacade* facade()
+    {
+        return this->getFacade();
+    }
+};
+// gets the facade of one notifier over and over, counting wrong answers
+struct SharedNotifier
+{
+    FacadeReader* reader;
+    IFacade* facade;
+    int wrong;
+};
+static void* readSharedFacade(void* argument)
+{
+    SharedNotifier* shared = (SharedNotifier*) argument;
+    for(int i = 0; i < 2000; i++)
+        if(shared->reader->facade() != shared->facade)
+            __atomic_add_fetch(&shared->wrong, 1, __ATOMIC_RELAXED);
+    return 0;
+}
 class NotifierTestSuite : public CxxTest::TestSuite
 {
 public:
@@ -157,6 +571,43 @@ public:
         this->notifier->sendNotification(this->noteName);
         TS_ASSERT_EQUALS(SimpleTestClass::executions, 3);
     }
+    void testSendNotificationUsesCachedFacade()
+    {
+        this->notifier->sendNotification(1 + this->noteName);
+        size_t before = allocations;
+        for(int i = 0; i < 1000; i++)
+            this->notifier->sendNotification(1 + this->noteName);
+        TS_ASSERT_EQUALS(allocations, before);
+    }
+    void testRemovingCoreDropsCachedFacade()
+    {
+        this->notifier->sendNotification(this->noteName);
+        TS_ASSERT_EQUALS(SimpleTestClass::executions, 3);
+        Facade::removeCore(this->key);
+        this->facade = Facade::getInstance(this->key);
+        this->getFacade()->registerCommand<SimpleTestClass>(this->noteName);
+        this->notifier->sendNotification(this->noteName);
+        TS_ASSERT_EQUALS(SimpleTestClass::executions, 4);
+    }
+    void testThreadsShareANotifiersCachedFacade()
+    {
+        // removing any core drops the cache, so every thread starts out resolving it
+        FacadeReader reader;
+        reader.initializeNotifier(this->key);
+        Facade::getInstance("NotifierTestSuiteOtherKey");
+        Facade::removeCore("NotifierTestSuiteOtherKey");
+        const int threads = 4;
+        SharedNotifier shared;
+        shared.reader = &reader;
+        shared.facade = this->facade;
+        shared.wrong = 0;
+        pthread_t ids[threads];
+        for(int i = 0; i < threads; i++)
+            pthread_create(&ids[i], NULL, readSharedFacade, &shared);
+        for(int i = 0; i < threads; i++)
+            pthread_join(ids[i], NULL);
+        TS_ASSERT_EQUALS(shared.wrong, 0);
+    }
 
 private:
     Notifier* notifier;
@@ -190,6 +641,41 @@ public:
     }
     INotification* memberNotification;
 };
+// throws the type of the notification it is given
+class ThrowingObject
+{
+public:
+    void callbackMethod(INotification* notification)
+    {
+        throw notification->getType();
+    }
+};
+class MutatingObject
+{
+public:
+    MutatingObject(IView* view, int noteName, InterestedObject* victim, IObserverRestricted* recruit)
+    {
+        this->view = view;
+        this->noteName = noteName;
+        this->victim = victim;
+        this->recruit = recruit;
+    }
+    // removes the victim and registers the recruit on the list being notified
+    void callbackMethod(INotification* notification)
+    {
+        if(this->victim != (InterestedObject*) 0)
+            this->view->removeObserver(this->noteName, (intptr_t) &*this->victim);
+        if(this->recruit != (IObserverRestricted*) 0)
+            this->view->registerObserver(this->noteName, this->recruit);
+        this->victim = (InterestedObject*) 0;
+        this->recruit = (IObserverRestricted*) 0;
+    }
+private:
+    IView* view;
+    int noteName;
+    InterestedObject* victim;
+    IObserverRestricted* recruit;
+};
 class ObserverTestSuite : public CxxTest::TestSuite
 {
 public:
@@ -217,6 +703,22 @@ public:
         TS_ASSERT(! this->observer->compareNotifyContext((intptr_t) &*newInterestedObject));
         TS_ASSERT(this->observer->compareNotifyContext((intptr_t) &*this->contextObject));
     }
+    void testDelegatesCallBoundMembersAndObservers()
+    {
+        Delegate bound = Delegate::bind<InterestedObject, &InterestedObject::callbackMethod>(this->contextObject);
+        TS_ASSERT_EQUALS(sizeof(bound), 2 * sizeof(void*));
+        bound(this->notification);
+        TS_ASSERT_EQUALS(this->contextObject->memberNotification->getName(), this->noteName);
+        TS_ASSERT(bound.compareNotifyContext((intptr_t) &*this->contextObject));
+        TS_ASSERT(! bound.compareNotifyContext((intptr_t) &*this->observer));
+        // a wrapped observer compares by the observer's context, not the observer
+        Delegate wrapped(this->observer);
+        this->contextObject->memberNotification = new Notification(1 + this->noteName);
+        wrapped(this->notification);
+        TS_ASSERT_EQUALS(this->contextObject->memberNotification->getName(), this->noteName);
+        TS_ASSERT(wrapped.compareNotifyContext((intptr_t) &*this->contextObject));
+        TS_ASSERT(! wrapped.compareNotifyContext((intptr_t) &*this->observer));
+    }
 private:
     int noteName;
     int noteType;
@@ -262,6 +764,166 @@ private:
     bool calledRegister;
     int ones;
 };
+// counts how often it is constructed, and takes its time registering
+class LazyProxy : public Proxy
+{
+public:
+    LazyProxy(std::string name) : Proxy(name)
+    {
+        __atomic_add_fetch(&LazyProxy::constructed, 1, __ATOMIC_SEQ_CST);
+        this->foundItself = false;
+    }
+    void onRegister()
+    {
+        usleep(2000);
+        this->foundItself = Model::getInstance(this->getMultitonKey())->retrieveProxy(this->getProxyName()) == this;
+    }
+    void onRemove() {}
+    bool foundItself;
+    static int constructed;
+};
+int LazyProxy::constructed = 0;
+// records when its onRegister ran, and whether the proxies it needs were there
+class DependentProxy : public Proxy
+{
+public:
+    DependentProxy(std::string name) : Proxy(name)
+    {
+        this->started = 0;
+        this->finished = 0;
+        this->foundDependencies = false;
+        this->hiddenWhileRegistering = false;
+    }
+    void onRegister()
+    {
+        this->started = __atomic_add_fetch(&DependentProxy::clock, 1, __ATOMIC_SEQ_CST);
+        int running = __atomic_add_fetch(&DependentProxy::running, 1, __ATOMIC_SEQ_CST);
+        int most = __atomic_load_n(&DependentProxy::mostRunning, __ATOMIC_SEQ_CST);
+        while(running > most && ! __atomic_compare_exchange_n(&DependentProxy::mostRunning, &most, running, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+            ;
+        this->foundDependencies = true;
+        IModel* model = Model::getInstance(this->getMultitonKey());
+        for(size_t i = 0; i < this->dependencies.size(); i++)
+            this->foundDependencies = this->foundDependencies && model->hasProxy(this->dependencies[i])
+                && model->retrieveProxy(this->dependencies[i]) != (IProxy*) 0;
+        this->hiddenWhileRegistering = ! model->hasProxy(this->getProxyName());
+        usleep(2000);
+        __atomic_sub_fetch(&DependentProxy::running, 1, __ATOMIC_SEQ_CST);
+        this->finished = __atomic_add_fetch(&DependentProxy::clock, 1, __ATOMIC_SEQ_CST);
+    }
+    void onRemove() {}
+    std::vector<std::string> dependencies;
+    int started;
+    int finished;
+    bool foundDependencies;
+    bool hiddenWhileRegistering;
+    static int clock;
+    static int running;
+    static int mostRunning;
+};
+int DependentProxy::clock = 0;
+int DependentProxy::running = 0;
+int DependentProxy::mostRunning = 0;
+struct LazyRetrieval
+{
+    IModel* model;
+    const char* name;
+    IProxy* found;
+};
+static void* retrieveLazily(void* argument)
+{
+    LazyRetrieval* retrieval = (LazyRetrieval*) argument;
+    retrieval->found = retrieval->model->retrieveProxy(retrieval->name);
+    return 0;
+}
+// a lazy proxy that registers proxies of its own, enough to grow the model
+class RegisteringProxy : public Proxy
+{
+public:
+    RegisteringProxy(std::string name) : Proxy(name) {}
+    void onRegister()
+    {
+        IModel* model = Model::getInstance(this->getMultitonKey());
+        for(int i = 0; i < 300; i++)
+        {
+            char name[32];
+            sprintf(name, "registered%d", i);
+            this->registered.push_back(new ProxyTestClass(std::string(name)));
+            model->registerProxy(this->registered.back());
+            if(i % 16 == 0)
+                sched_yield();
+        }
+    }
+    void onRemove() {}
+    std::vector<IProxy*> registered;
+};
+// retrieves proxies by name and by handle until told to stop
+struct ConcurrentRetrieval
+{
+    IModel* model;
+    std::vector<std::string> names;
+    std::vector<IProxy*> proxies;
+    std::vector<ProxyHandle> handles;
+    int stop;
+    bool found;
+};
+static void* retrieveUntilStopped(void* argument)
+{
+    ConcurrentRetrieval* retrieval = (ConcurrentRetrieval*) argument;
+    do
+    {
+        for(size_t i = 0; i < retrieval->names.size(); i++)
+        {
+            retrieval->found = retrieval->found && retrieval->model->retrieveProxy(retrieval->names[i]) == retrieval->proxies[i];
+            retrieval->found = retrieval->found && retrieval->model->retrieveProxy(retrieval->handles[i]) == retrieval->proxies[i];
+        }
+        sched_yield();
+    }
+    while(! __atomic_load_n(&retrieval->stop, __ATOMIC_ACQUIRE));
+    return 0;
+}
+// data that is torn if count, doubled and text disagree
+struct Reading
+{
+    Reading() : count(0), doubled(0), text("0") {}
+    long count;
+    long doubled;
+    std::string text;
+};
+class ReadingProxy : public VersionedProxy<Reading>
+{
+public:
+    ReadingProxy() : VersionedProxy<Reading>("readings") {}
+    void onRegister() {}
+    void onRemove() {}
+};
+struct ReadingReader
+{
+    ReadingProxy* proxy;
+    bool stop;
+    long reads;
+    long torn;
+    long backwards;
+};
+static void* readReadings(void* argument)
+{
+    ReadingReader* reader = (ReadingReader*) argument;
+    unsigned long last = 0;
+    do
+    {
+        VersionedProxy<Reading>::Snapshot reading = reader->proxy->read();
+        char text[32];
+        sprintf(text, "%ld", reading->count);
+        if(reading->doubled != 2 * reading->count || reading->text != text)
+            reader->torn++;
+        if(reading.getVersion() < last)
+            reader->backwards++;
+        last = reading.getVersion();
+        reader->reads++;
+    }
+    while(! __atomic_load_n(&reader->stop, __ATOMIC_ACQUIRE));
+    return 0;
+}
 class ProxyTestSuite : public CxxTest::TestSuite
 {
 public:
@@ -300,7 +962,74 @@ public:
         this->proxy->onRegister();
         TS_ASSERT_DIFFERS(*(int*) this->proxy->getData(), threes); // should be 111
     }
+    void testVersionedProxiesPublishWholeSnapshots()
+    {
+        ReadingProxy proxy;
+        const int readers = 3;
+        ReadingReader arguments[readers];
+        pthread_t threads[readers];
+        for(int i = 0; i < readers; i++)
+        {
+            ReadingReader reader = { &proxy, false, 0, 0, 0 };
+            arguments[i] = reader;
+            pthread_create(&threads[i], NULL, readReadings, &arguments[i]);
+        }
+        Reading reading;
+        for(long i = 1; i <= 3000; i++)
+        {
+            char text[32];
+            sprintf(text, "%ld", i);
+            reading.count = i;
+            reading.doubled = 2 * i;
+            reading.text = text;
+            TS_ASSERT_EQUALS(proxy.publish(reading), (unsigned long) i + 1);
+            // give the readers a look in, even on one processor
+            if(i % 64 == 0)
+                sched_yield();
+        }
+        for(int i = 0; i < readers; i++)
+        {
+            __atomic_store_n(&arguments[i].stop, true, __ATOMIC_RELEASE);
+            pthread_join(threads[i], NULL);
+            TS_ASSERT(arguments[i].reads > 0);
+            TS_ASSERT_EQUALS(arguments[i].torn, 0);
+            TS_ASSERT_EQUALS(arguments[i].backwards, 0);
+        }
+        TS_ASSERT_EQUALS(proxy.getVersion(), 3001u);
+        TS_ASSERT_EQUALS(proxy.read()->count, 3000);
+    }
+    void testSnapshotsKeepTheirVersionAlive()
+    {
+        int live = LargeTracked::live;
+        {
+            VersionedProxy<LargeTracked>::Snapshot first;
+            TS_ASSERT_EQUALS(first.getVersion(), 0u);
+            {
+                ProxyVersions proxy(LargeTracked(1));
+                first = proxy.read();
+                proxy.publish(LargeTracked(2));
+                proxy.publish(LargeTracked(3));
+                // the middle version went when it was replaced
+                TS_ASSERT_EQUALS(LargeTracked::live, live + 2);
+                TS_ASSERT_EQUALS(first->value, 1);
+                TS_ASSERT_EQUALS(proxy.read()->value, 3);
+                TS_ASSERT_EQUALS(proxy.getVersion(), 3u);
+            }
+            // and the first outlives the proxy
+            TS_ASSERT_EQUALS(first->value, 1);
+            TS_ASSERT_EQUALS(first.getVersion(), 1u);
+            TS_ASSERT_EQUALS(LargeTracked::live, live + 1);
+        }
+        TS_ASSERT_EQUALS(LargeTracked::live, live);
+    }
 private:
+    class ProxyVersions : public VersionedProxy<LargeTracked>
+    {
+    public:
+        ProxyVersions(const LargeTracked& data) : VersionedProxy<LargeTracked>("versions", data) {}
+        void onRegister() {}
+        void onRemove() {}
+    };
     Proxy* proxy;
 };
 //--------------------------------------
@@ -364,6 +1093,69 @@ public:
     bool registered;
     bool removed;
 };
+// takes a batch of int bodies in one call
+class BatchMediator : public Mediator
+{
+public:
+    BatchMediator(std::string name, int interest) : Mediator(name)
+    {
+        this->interest = interest;
+        this->batches = 0;
+        this->sum = 0;
+        this->type = 0;
+    }
+    void onRegister(){}
+    void onRemove(){}
+    std::vector<int> listNotificationInterests()
+    {
+        return std::vector<int>(1, this->interest);
+    }
+    void handleNotification(INotification* notification){}
+    void handleNotifications(int notificationName, void* const* bodies, size_t count, int notificationType)
+    {
+        this->batches++;
+        this->type = notificationType;
+        for(size_t i = 0; i < count; i++)
+            this->sum += *(int*) bodies[i];
+    }
+    int interest;
+    int batches;
+    int sum;
+    int type;
+};
+// implements IMediator without extending Mediator
+class PlainMediator : public Notifier, public IMediator
+{
+public:
+    PlainMediator(std::string name, int interest)
+    {
+        this->name = name;
+        this->interest = interest;
+        this->sum = 0;
+    }
+    std::string getMediatorName()
+    {
+        return this->name;
+    }
+    std::vector<int> listNotificationInterests()
+    {
+        return std::vector<int>(1, this->interest);
+    }
+    void* getViewComponent()
+    {
+        return (void*) 0;
+    }
+    void setViewComponent(void* viewComponent){}
+    void onRegister(){}
+    void onRemove(){}
+    void handleNotification(INotification* notification)
+    {
+        this->sum += *(int*) notification->getBody();
+    }
+    std::string name;
+    int interest;
+    int sum;
+};
 class MediatorTestSuite : public CxxTest::TestSuite
 {
 public:
@@ -450,6 +1242,100 @@ public:
         this->getView()->notifyObservers(this->notification);
         TS_ASSERT_DIFFERS(this->contextObject->memberNotification->getName(), this->noteName);
     }
+    void testCanNotifyDenseAndSparseNames()
+    {
+        int names[] = { 3, -5, 100000 };
+        for(int i = 0; i < 3; i++)
+        {
+            this->getView()->registerObserver(names[i], this->observer);
+            this->getView()->notifyObservers(new Notification(names[i], this->noteType));
+            TS_ASSERT_EQUALS(this->contextObject->memberNotification->getName(), names[i]);
+        }
+        // moving the lists between storage modes keeps them intact
+        this->getView()->setDenseNameLimit(0);
+        this->getView()->notifyObservers(new Notification(3, this->noteType));
+        TS_ASSERT_EQUALS(this->contextObject->memberNotification->getName(), 3);
+        this->getView()->setDenseNameLimit(View::DEFAULT_DENSE_NAME_LIMIT);
+        this->getView()->notifyObservers(new Notification(-5, this->noteType));
+        TS_ASSERT_EQUALS(this->contextObject->memberNotification->getName(), -5);
+        for(int i = 0; i < 3; i++)
+            this->getView()->removeObserver(names[i], (intptr_t) &*this->contextObject);
+        this->getView()->notifyObservers(new Notification(100000, this->noteType));
+        this->getView()->notifyObservers(new Notification(3, this->noteType));
+        TS_ASSERT_EQUALS(this->contextObject->memberNotification->getName(), -5);
+    }
+    void testCanRemoveObserverBySubscription()
+    {
+        InterestedObject objects[4];
+        Subscription subscriptions[4];
+        for(int i = 0; i < 3; i++)
+            subscriptions[i] = this->view->registerObserver(this->noteName, new Observer<InterestedObject>(&InterestedObject::callbackMethod, &objects[i]));
+        this->view->removeObserver(subscriptions[1]);
+        // the freed slot goes to the next registration, the stale handle must not remove it
+        subscriptions[3] = this->view->registerObserver(this->noteName, new Observer<InterestedObject>(&InterestedObject::callbackMethod, &objects[3]));
+        this->view->removeObserver(subscriptions[1]);
+        this->view->removeObserver(Subscription());
+        this->view->notifyObservers(this->notification);
+        TS_ASSERT_EQUALS(objects[0].memberNotification->getName(), this->noteName);
+        TS_ASSERT_EQUALS(objects[1].memberNotification->getName(), 999);
+        TS_ASSERT_EQUALS(objects[2].memberNotification->getName(), this->noteName);
+        TS_ASSERT_EQUALS(objects[3].memberNotification->getName(), this->noteName);
+        // handles stay good while the list is compacted around them
+        std::vector<Subscription> crowd;
+        for(int i = 0; i < 1000; i++)
+            crowd.push_back(this->view->registerObserver(this->noteName, new Observer<InterestedObject>(&InterestedObject::callbackMethod, &objects[1])));
+        for(int i = 0; i < 1000; i += 2)
+            this->view->removeObserver(crowd[i]);
+        this->view->removeObserver(subscriptions[0]);
+        this->view->removeObserver(subscriptions[3]);
+        for(int i = 1; i < 1000; i += 2)
+            this->view->removeObserver(crowd[i]);
+        INotification* last = new Notification(this->noteName, 1 + this->noteType);
+        this->view->notifyObservers(last);
+        TS_ASSERT_EQUALS(objects[0].memberNotification->getType(), this->noteType);
+        TS_ASSERT_EQUALS(objects[1].memberNotification->getName(), 999);
+        TS_ASSERT_EQUALS(objects[2].memberNotification->getType(), 1 + this->noteType);
+        TS_ASSERT_EQUALS(objects[3].memberNotification->getType(), this->noteType);
+        this->view->removeObserver(subscriptions[2]);
+    }
+    void testObserverListsRecoverFromAThrowingObserver()
+    {
+        int thrower = this->noteName + 1;
+        ThrowingObject throwing;
+        Subscription throwingSubscription = this->view->registerObserver(thrower, Delegate::bind<ThrowingObject, &ThrowingObject::callbackMethod>(&throwing));
+        Notification note(thrower, this->noteType);
+        TS_ASSERT_THROWS(this->view->notifyObservers(&note), int);
+        void* body = 0;
+        TS_ASSERT_THROWS(this->view->notifyObserversBatch(thrower, &body, 1, this->noteType), int);
+        // the list is compacted again, so coming and going does not grow it
+        InterestedObject passing;
+        Delegate delegate = Delegate::bind<InterestedObject, &InterestedObject::callbackMethod>(&passing);
+        this->view->removeObserver(this->view->registerObserver(thrower, delegate));
+        size_t before = allocations;
+        for(int i = 0; i < 1000; i++)
+            this->view->removeObserver(this->view->registerObserver(thrower, delegate));
+        TS_ASSERT_EQUALS(allocations, before);
+        this->view->removeObserver(throwingSubscription);
+    }
+    void testObserversCanMutateListDuringNotification()
+    {
+        InterestedObject* recruitObject = new InterestedObject();
+        IObserverRestricted* recruit = new Observer<InterestedObject>(&InterestedObject::callbackMethod, recruitObject);
+        MutatingObject* mutator = new MutatingObject(this->view, this->noteName, this->contextObject, recruit);
+        this->view->registerObserver(this->noteName, new Observer<MutatingObject>(&MutatingObject::callbackMethod, mutator));
+        this->view->registerObserver(this->noteName, this->observer);
+        // the removed observer still gets this note, the added one does not
+        this->view->notifyObservers(this->notification);
+        TS_ASSERT_EQUALS(this->contextObject->memberNotification->getName(), this->noteName);
+        TS_ASSERT_EQUALS(recruitObject->memberNotification->getName(), 999);
+        // the next note goes to the added observer only
+        INotification* next = new Notification(this->noteName, 1 + this->noteType);
+        this->view->notifyObservers(next);
+        TS_ASSERT_EQUALS(this->contextObject->memberNotification->getType(), this->noteType);
+        TS_ASSERT_EQUALS(recruitObject->memberNotification->getType(), 1 + this->noteType);
+        this->view->removeObserver(this->noteName, (intptr_t) &*mutator);
+        this->view->removeObserver(this->noteName, (intptr_t) &*recruitObject);
+    }
     void testCanRegisterAndRetrieveMediator()
     {
         this->view->registerMediator(this->mediator);
@@ -537,6 +1423,248 @@ public:
         TS_ASSERT(! this->model->hasProxy(this->proxyName));
         TS_ASSERT(this->getProxy()->removed);
     }
+    void testLookingUpMissingProxiesRegistersNothing()
+    {
+        TS_ASSERT(this->model->retrieveProxy("missing") == (IProxy*) 0);
+        TS_ASSERT(! this->model->hasProxy("missing"));
+        TS_ASSERT(this->model->removeProxy("missing") == (IProxy*) 0);
+        // enough proxies to grow the table, then remove every other one
+        std::vector<ProxyTestClass*> proxies;
+        for(int i = 0; i < 200; i++)
+        {
+            char name[32];
+            sprintf(name, "proxy%d", i);
+            proxies.push_back(new ProxyTestClass(std::string(name)));
+            this->model->registerProxy(proxies[i]);
+        }
+        TS_ASSERT_EQUALS(this->getModel()->retrieveProxy(std::string("proxy7")), (IProxy*) proxies[7]);
+        for(int i = 0; i < 200; i += 2)
+            TS_ASSERT_EQUALS(this->model->removeProxy(proxies[i]->getProxyName()), (IProxy*) proxies[i]);
+        for(int i = 0; i < 200; i++)
+        {
+            IProxy* found = this->model->retrieveProxy(proxies[i]->getProxyName());
+            TS_ASSERT_EQUALS(found, i % 2 == 0 ? (IProxy*) 0 : (IProxy*) proxies[i]);
+            if(i % 2 == 1)
+                this->model->removeProxy(proxies[i]->getProxyName());
+            delete proxies[i];
+        }
+        TS_ASSERT(! this->model->hasProxy("proxy199"));
+    }
+    void testLazyProxiesAreConstructedOnceOnFirstRetrieval()
+    {
+        LazyProxy::constructed = 0;
+        this->getModel()->registerProxyFactory<LazyProxy>("lazy");
+        this->getModel()->registerProxyFactory<LazyProxy>("neverRetrieved");
+        TS_ASSERT(this->model->hasProxy("lazy"));
+        TS_ASSERT_EQUALS(LazyProxy::constructed, 0);
+        // every thread gets the one proxy, once it has registered
+        const int threads = 8;
+        LazyRetrieval retrievals[threads];
+        pthread_t ids[threads];
+        for(int i = 0; i < threads; i++)
+        {
+            retrievals[i].model = this->model;
+            retrievals[i].name = "lazy";
+            pthread_create(&ids[i], NULL, retrieveLazily, &retrievals[i]);
+        }
+        for(int i = 0; i < threads; i++)
+            pthread_join(ids[i], NULL);
+        TS_ASSERT_EQUALS(LazyProxy::constructed, 1);
+        LazyProxy* lazy = dynamic_cast<LazyProxy*>(retrievals[0].found);
+        TS_ASSERT(lazy != (LazyProxy*) 0);
+        TS_ASSERT(lazy->foundItself);
+        for(int i = 1; i < threads; i++)
+            TS_ASSERT_EQUALS(retrievals[i].found, retrievals[0].found);
+        TS_ASSERT_EQUALS(lazy->getProxyName(), "lazy");
+        TS_ASSERT_EQUALS(ProxyRef<LazyProxy>(this->model, "lazy").get(), lazy);
+        // removing one that was never retrieved constructs nothing
+        TS_ASSERT(this->model->removeProxy("neverRetrieved") == (IProxy*) 0);
+        TS_ASSERT(! this->model->hasProxy("neverRetrieved"));
+        TS_ASSERT_EQUALS(LazyProxy::constructed, 1);
+        TS_ASSERT_EQUALS(this->model->removeProxy("lazy"), (IProxy*) lazy);
+        delete lazy;
+        delete this->proxy;
+    }
+    void testRegisterProxiesHonorsDependencies()
+    {
+        // a tree, each proxy depending on its parent, then a cycle and a proxy behind it
+        std::vector<DependentProxy*> proxies;
+        std::vector<ProxyRegistration> registrations;
+        for(int i = 0; i < 40; i++)
+        {
+            char name[32];
+            sprintf(name, "dependent%d", i);
+            proxies.push_back(new DependentProxy(std::string(name)));
+            if(i > 0)
+                proxies[i]->dependencies.push_back(proxies[(i - 1) / 2]->getProxyName());
+        }
+        proxies.push_back(new DependentProxy(std::string("cycleA")));
+        proxies.push_back(new DependentProxy(std::string("cycleB")));
+        proxies.push_back(new DependentProxy(std::string("behindCycle")));
+        proxies[40]->dependencies.push_back("cycleB");
+        proxies[41]->dependencies.push_back("cycleA");
+        proxies[42]->dependencies.push_back("cycleA");
+        // registered already, and missing, dependencies are met
+        this->model->registerProxy(this->proxy);
+        proxies[1]->dependencies.push_back(this->proxyName);
+        for(size_t i = 0; i < proxies.size(); i++)
+        {
+            registrations.push_back(ProxyRegistration(proxies[i]));
+            for(size_t j = 0; j < proxies[i]->dependencies.size(); j++)
+                registrations.back().dependsOn(proxies[i]->dependencies[j]);
+        }
+        registrations[2].dependsOn("missing");
+        // a name that's taken is skipped
+        DependentProxy duplicate(std::string("dependent3"));
+        registrations.push_back(ProxyRegistration(&duplicate));
+        DependentProxy::mostRunning = 0;
+        this->model->registerProxies(registrations);
+
+        TS_ASSERT_EQUALS(duplicate.started, 0);
+        for(size_t i = 0; i < proxies.size(); i++)
+        {
+            TS_ASSERT(proxies[i]->finished != 0);
+            // in a cycle, someone goes first
+            TS_ASSERT(proxies[i]->foundDependencies || i == 40);
+            // until its onRegister returns, a proxy isn't reported
+            TS_ASSERT(proxies[i]->hiddenWhileRegistering);
+            TS_ASSERT(this->model->hasProxy(proxies[i]->getProxyName()));
+            TS_ASSERT_EQUALS(this->model->retrieveProxy(proxies[i]->getProxyName()), (IProxy*) proxies[i]);
+            if(i > 0 && i < 40)
+                TS_ASSERT(proxies[(i - 1) / 2]->finished < proxies[i]->started);
+        }
+        // the cycle is left until everything else is done
+        TS_ASSERT(proxies[39]->finished < proxies[40]->started);
+        TS_ASSERT(proxies[41]->finished < proxies[42]->started);
+        if(ThreadPool::shared()->size() > 1)
+            TS_ASSERT(DependentProxy::mostRunning > 1);
+
+        for(size_t i = 0; i < proxies.size(); i++)
+        {
+            this->model->removeProxy(proxies[i]->getProxyName());
+            delete proxies[i];
+        }
+        this->model->removeProxy(this->proxyName);
+        delete this->proxy;
+    }
+    void testBatchesMayRetrieveLazyProxiesThatRegisterMore()
+    {
+        // the first onRegister to retrieve it constructs the registrar,
+        // while the rest of the batch is published around it
+        this->getModel()->registerProxyFactory<RegisteringProxy>("registering");
+        std::vector<DependentProxy*> proxies;
+        std::vector<ProxyRegistration> registrations;
+        for(int i = 0; i < 16; i++)
+        {
+            char name[32];
+            sprintf(name, "batched%d", i);
+            proxies.push_back(new DependentProxy(std::string(name)));
+            proxies[i]->dependencies.push_back("registering");
+            registrations.push_back(ProxyRegistration(proxies[i]));
+        }
+        this->model->registerProxies(registrations);
+        bool found = true;
+        for(size_t i = 0; i < proxies.size(); i++)
+        {
+            found = found && proxies[i]->foundDependencies;
+            found = found && this->model->retrieveProxy(proxies[i]->getProxyName()) == proxies[i];
+        }
+        TS_ASSERT(found);
+        RegisteringProxy* registering = dynamic_cast<RegisteringProxy*>(this->model->retrieveProxy("registering"));
+        TS_ASSERT(registering != (RegisteringProxy*) 0);
+        TS_ASSERT_EQUALS(registering->registered.size(), 300u);
+        TS_ASSERT(this->model->hasProxy("registered299"));
+
+        for(size_t i = 0; i < registering->registered.size(); i++)
+        {
+            this->model->removeProxy(registering->registered[i]->getProxyName());
+            delete registering->registered[i];
+        }
+        for(size_t i = 0; i < proxies.size(); i++)
+        {
+            this->model->removeProxy(proxies[i]->getProxyName());
+            delete proxies[i];
+        }
+        this->model->removeProxy("registering");
+        delete registering;
+        delete this->proxy;
+    }
+    void testProxyRefsFollowTheirRegistration()
+    {
+        this->model->registerProxy(this->proxy);
+        ProxyRef<ProxyTestClass> ref(this->model, this->proxyName);
+        TS_ASSERT_EQUALS(ref.get(), this->getProxy());
+        TS_ASSERT(ref->registered);
+        // the wrong type or name refer to nothing
+        TS_ASSERT(! ProxyRef<ModelTestSuite>(this->model, this->proxyName));
+        TS_ASSERT(! ProxyRef<ProxyTestClass>(this->model, "missing"));
+        TS_ASSERT(! ProxyRef<ProxyTestClass>());
+        // a proxy registered again under the name is a new registration
+        this->model->removeProxy(this->proxyName);
+        TS_ASSERT(ref.get() == (ProxyTestClass*) 0);
+        ProxyTestClass again(this->proxyName);
+        this->model->registerProxy(&again);
+        TS_ASSERT(! ref);
+        TS_ASSERT_EQUALS(ProxyRef<ProxyTestClass>(this->model, this->proxyName).get(), &again);
+        this->model->removeProxy(this->proxyName);
+        delete this->proxy;
+    }
+    void testLazyProxiesMayRegisterProxiesWhileOthersRetrieve()
+    {
+        std::vector<IProxy*> proxies;
+        for(int i = 0; i < 12; i++)
+        {
+            char name[32];
+            sprintf(name, "retrieved%d", i);
+            proxies.push_back(new ProxyTestClass(std::string(name)));
+            this->model->registerProxy(proxies.back());
+        }
+        this->getModel()->registerProxyFactory<RegisteringProxy>("registering");
+        // readers keep finding the same proxies as the names and slots grow
+        const int threads = 4;
+        ConcurrentRetrieval retrievals[threads];
+        pthread_t ids[threads];
+        for(int i = 0; i < threads; i++)
+        {
+            retrievals[i].model = this->model;
+            for(size_t j = 0; j < proxies.size(); j++)
+            {
+                retrievals[i].names.push_back(proxies[j]->getProxyName());
+                retrievals[i].proxies.push_back(proxies[j]);
+                retrievals[i].handles.push_back(this->model->retrieveProxyHandle(proxies[j]->getProxyName()));
+            }
+            retrievals[i].stop = 0;
+            retrievals[i].found = true;
+            pthread_create(&ids[i], NULL, retrieveUntilStopped, &retrievals[i]);
+        }
+        RegisteringProxy* registering = dynamic_cast<RegisteringProxy*>(this->model->retrieveProxy("registering"));
+        for(int i = 0; i < threads; i++)
+        {
+            __atomic_store_n(&retrievals[i].stop, 1, __ATOMIC_RELEASE);
+            pthread_join(ids[i], NULL);
+            TS_ASSERT(retrievals[i].found);
+        }
+        TS_ASSERT(registering != (RegisteringProxy*) 0);
+        TS_ASSERT_EQUALS(registering->registered.size(), 300u);
+        bool registered = true;
+        for(size_t i = 0; i < registering->registered.size(); i++)
+            registered = registered && this->model->retrieveProxy(registering->registered[i]->getProxyName()) == registering->registered[i];
+        TS_ASSERT(registered);
+
+        for(size_t i = 0; i < registering->registered.size(); i++)
+        {
+            this->model->removeProxy(registering->registered[i]->getProxyName());
+            delete registering->registered[i];
+        }
+        for(size_t i = 0; i < proxies.size(); i++)
+        {
+            this->model->removeProxy(proxies[i]->getProxyName());
+            delete proxies[i];
+        }
+        this->model->removeProxy("registering");
+        delete registering;
+        delete this->proxy;
+    }
     void testCanRemoveModel()
     {
         TS_ASSERT(Multiton<Model>::exists(this->key));
@@ -606,6 +1734,84 @@ public:
         this->getController()->executeCommand<MacroTestClass>(this->notification);
         TS_ASSERT_EQUALS(SimpleTestClass::executions, 0);
     }
+    void testCommandLifetimes()
+    {
+        int lifetimes[] = { CommandLifetime::TRANSIENT, CommandLifetime::POOLED, CommandLifetime::SINGLETON };
+        int expected[] = { 3, 1, 1 };
+        for(int i = 0; i < 3; i++)
+        {
+            CountedCommand::constructions = 0;
+            CountedCommand::executions = 0;
+            this->getController()->registerCommand<CountedCommand>(1 + this->noteName, lifetimes[i]);
+            for(int n = 0; n < 3; n++)
+                this->getView()->notifyObservers(new Notification(1 + this->noteName));
+            TS_ASSERT_EQUALS(CountedCommand::executions, 3);
+            TS_ASSERT_EQUALS(CountedCommand::constructions, expected[i]);
+            this->controller->removeCommand(1 + this->noteName);
+        }
+    }
+    void testThrowingCommandsAreHandedBack()
+    {
+        int thrower = 3 + this->noteName;
+        ThrowingCommand::live = 0;
+        this->getController()->registerCommand<ThrowingCommand>(thrower, CommandLifetime::POOLED);
+        for(int n = 0; n < 3; n++)
+        {
+            Notification note(thrower, n);
+            TS_ASSERT_THROWS(this->getView()->notifyObservers(&note), int);
+        }
+        // the pool got its command back every time
+        TS_ASSERT_EQUALS(ThrowingCommand::live, 1);
+        // nothing is left executing, so the factory and its pool go at once
+        this->controller->removeCommand(thrower);
+        TS_ASSERT_EQUALS(ThrowingCommand::live, 0);
+    }
+    void testCommandsFollowTheViewsDenseNameLimit()
+    {
+        // names are found wherever the limit at the time put them
+        int names[] = { 2000, 5, 3000 };
+        int limits[] = { 4096, 0, View::DEFAULT_DENSE_NAME_LIMIT };
+        CountedCommand::executions = 0;
+        for(int i = 0; i < 3; i++)
+        {
+            this->getView()->setDenseNameLimit(limits[i]);
+            this->getController()->registerCommand<CountedCommand>(names[i]);
+        }
+        for(int i = 0; i < 3; i++)
+        {
+            TS_ASSERT(this->controller->hasCommand(names[i]));
+            this->getView()->notifyObservers(new Notification(names[i]));
+        }
+        TS_ASSERT_EQUALS(CountedCommand::executions, 3);
+        TS_ASSERT(! this->controller->hasCommand(6));
+        TS_ASSERT(! this->controller->hasCommand(2500));
+        for(int i = 0; i < 3; i++)
+            this->controller->removeCommand(names[i]);
+        TS_ASSERT(! this->controller->hasCommand(2000));
+    }
+    void testParallelCommandsRunOnThePool()
+    {
+        int lifetimes[] = { CommandLifetime::TRANSIENT, CommandLifetime::POOLED };
+        for(int i = 0; i < 2; i++)
+        {
+            ParallelCommand::executions = 0;
+            ParallelCommand::onSender = 0;
+            ParallelCommand::sender = pthread_self();
+            this->getController()->registerCommand<ParallelCommand>(2 + this->noteName, lifetimes[i], CommandExecution::PARALLEL);
+            for(int n = 0; n < 1000; n++)
+            {
+                // the sent notification is gone before the command runs
+                Notification note(2 + this->noteName, &this->noteType);
+                this->getView()->notifyObservers(&note);
+            }
+            // removing it while commands are in flight must not pull the factory out from under them
+            this->controller->removeCommand(2 + this->noteName);
+            ThreadPool::shared()->wait();
+            TS_ASSERT_EQUALS(ParallelCommand::executions, 1000);
+            TS_ASSERT_EQUALS(ParallelCommand::onSender, 0);
+            TS_ASSERT_EQUALS(ParallelCommand::lastBody, (void*) &this->noteType);
+        }
+    }
     void testCanRemoveController()
     {
         TS_ASSERT(Multiton<Controller>::exists(this->key));
@@ -634,12 +1840,336 @@ private:
     }
 };
 //--------------------------------------
+//  ThreadPool
+//--------------------------------------
+// fans out into a binary tree of tasks, submitted from inside the pool
+class FanOutTask : public ThreadPool::Task
+{
+public:
+    FanOutTask(ThreadPool* pool, int depth, int* runs)
+    {
+        this->pool = pool;
+        this->depth = depth;
+        this->runs = runs;
+    }
+    void run()
+    {
+        __atomic_add_fetch(this->runs, 1, __ATOMIC_RELAXED);
+        if(this->depth == 0)
+            return;
+        this->pool->submit(new FanOutTask(this->pool, this->depth - 1, this->runs));
+        this->pool->submit(new FanOutTask(this->pool, this->depth - 1, this->runs));
+    }
+private:
+    ThreadPool* pool;
+    int depth;
+    int* runs;
+};
+class ThreadPoolTestSuite : public CxxTest::TestSuite
+{
+public:
+    void testRunsEveryTaskSubmittedFromTasks()
+    {
+        ThreadPool pool(4);
+        TS_ASSERT_EQUALS(pool.size(), 4u);
+        int runs = 0;
+        pool.submit(new FanOutTask(&pool, 10, &runs));
+        pool.wait();
+        TS_ASSERT_EQUALS(runs, 2047);
+        // and again from outside, spread over the workers
+        for(int i = 0; i < 8; i++)
+            pool.submit(new FanOutTask(&pool, 4, &runs));
+        pool.wait();
+        TS_ASSERT_EQUALS(runs, 2047 + 8 * 31);
+    }
+    void testSharedPoolHasAWorkerPerProcessor()
+    {
+        TS_ASSERT_EQUALS(ThreadPool::shared(), ThreadPool::shared());
+        TS_ASSERT(ThreadPool::shared()->size() >= 1u);
+    }
+};
+//--------------------------------------
+//  NotificationPool
+//--------------------------------------
+static void* releaseNotification(void* notification)
+{
+    NotificationPool::release((Notification*) notification);
+    return 0;
+}
+class NotificationPoolTestSuite : public CxxTest::TestSuite
+{
+public:
+    void testRecyclesNotificationsAcrossThreads()
+    {
+        // warm this thread's cache up, then it shouldn't need to allocate
+        Notification* first = NotificationPool::acquire(1, (void*) 0, 2);
+        Notification* second = NotificationPool::acquire(1, (void*) 0, 2);
+        NotificationPool::release(second);
+        NotificationPool::release(first);
+        unsigned long created = NotificationPool::statistics().created;
+        Notification* note = NotificationPool::acquire(3, &this->body, 4);
+        TS_ASSERT_EQUALS(note, first);
+        TS_ASSERT_EQUALS(note->getName(), 3);
+        TS_ASSERT_EQUALS(note->getBody(), (void*) &this->body);
+        TS_ASSERT_EQUALS(note->getType(), 4);
+        // handed back on another thread, it comes home once the free list runs dry
+        pthread_t releaser;
+        pthread_create(&releaser, NULL, releaseNotification, note);
+        pthread_join(releaser, NULL);
+        TS_ASSERT_EQUALS(NotificationPool::acquire(0, (void*) 0, 0), second);
+        TS_ASSERT_EQUALS(NotificationPool::acquire(0, (void*) 0, 0), first);
+        NotificationPool::release(first);
+        NotificationPool::release(second);
+        TS_ASSERT_EQUALS(NotificationPool::statistics().created, created);
+        TS_ASSERT(NotificationPool::statistics().highWater >= 2u);
+        TS_ASSERT(NotificationPool::statistics().threads >= 1u);
+    }
+private:
+    int body;
+};
+//--------------------------------------
+//  NotificationRing
+//--------------------------------------
+// pushes notifications named 0, 1, 2... with the producer's number as their type
+struct RingProducer
+{
+    NotificationRing* ring;
+    int producer;
+    int count;
+};
+static void* produceNotifications(void* argument)
+{
+    RingProducer* producer = (RingProducer*) argument;
+    for(int i = 0; i < producer->count; i++)
+        producer->ring->push(NotificationPool::acquire(i, (void*) 0, producer->producer));
+    return 0;
+}
+class NotificationRingTestSuite : public CxxTest::TestSuite
+{
+public:
+    void testFullRingsFollowTheirPolicy()
+    {
+        NotificationRing failing(3, Backpressure::FAIL);
+        TS_ASSERT_EQUALS(failing.statistics().capacity, 4u);
+        for(int i = 0; i < 4; i++)
+            TS_ASSERT(failing.push(NotificationPool::acquire(i, (void*) 0, 0)));
+        Notification* refused = NotificationPool::acquire(4, (void*) 0, 0);
+        TS_ASSERT(! failing.push(refused));
+        NotificationPool::release(refused);
+        TS_ASSERT_EQUALS(failing.statistics().rejected, 1u);
+        TS_ASSERT_EQUALS(failing.statistics().highWater, 4u);
+
+        NotificationRing dropping(4, Backpressure::DROP_OLDEST);
+        for(int i = 0; i < 6; i++)
+            TS_ASSERT(dropping.push(NotificationPool::acquire(i, (void*) 0, 0)));
+        TS_ASSERT_EQUALS(dropping.size(), 4u);
+        TS_ASSERT_EQUALS(dropping.statistics().dropped, 2u);
+        for(int i = 2; i < 6; i++)
+        {
+            Notification* notification = dropping.pop();
+            TS_ASSERT_EQUALS(notification->getName(), i);
+            NotificationPool::release(notification);
+        }
+        TS_ASSERT(dropping.empty());
+        TS_ASSERT(dropping.pop() == (Notification*) 0);
+    }
+    void testProducersBlockUntilTheConsumerCatchesUp()
+    {
+        NotificationRing ring(64, Backpressure::BLOCK);
+        const int producers = 4;
+        const int count = 20000;
+        RingProducer arguments[producers];
+        pthread_t threads[producers];
+        for(int i = 0; i < producers; i++)
+        {
+            arguments[i].ring = &ring;
+            arguments[i].producer = i;
+            arguments[i].count = count;
+            pthread_create(&threads[i], NULL, produceNotifications, &arguments[i]);
+        }
+        // every producer's notifications arrive, in the order it pushed them
+        int next[producers] = { 0 };
+        int received = 0;
+        bool ordered = true;
+        while(received < producers * count)
+        {
+            Notification* notification = ring.pop();
+            if(notification == (Notification*) 0)
+                continue;
+            ordered = ordered && notification->getName() == next[notification->getType()]++;
+            NotificationPool::release(notification);
+            received++;
+        }
+        for(int i = 0; i < producers; i++)
+            pthread_join(threads[i], NULL);
+        TS_ASSERT(ordered);
+        TS_ASSERT(ring.empty());
+        TS_ASSERT(ring.statistics().highWater <= 64u);
+        TS_ASSERT_EQUALS(ring.statistics().dropped, 0u);
+    }
+    void testBlockedProducersSleepUntilAPopMakesRoom()
+    {
+        NotificationRing ring(2, Backpressure::BLOCK);
+        TS_ASSERT(ring.push(NotificationPool::acquire(0, (void*) 0, 0)));
+        TS_ASSERT(ring.push(NotificationPool::acquire(1, (void*) 0, 0)));
+        RingProducer blocked;
+        blocked.ring = &ring;
+        blocked.producer = 1;
+        blocked.count = 1;
+        pthread_t thread;
+        pthread_create(&thread, NULL, produceNotifications, &blocked);
+        // it gives up retrying and goes to sleep
+        for(int waited = 0; waited < 5000 && ring.statistics().parked == 0; waited++)
+            usleep(1000);
+        TS_ASSERT_EQUALS(ring.statistics().parked, 1u);
+        TS_ASSERT_EQUALS(ring.size(), 2u);
+        // a pop wakes it
+        Notification* notification = ring.pop();
+        TS_ASSERT_EQUALS(notification->getName(), 0);
+        NotificationPool::release(notification);
+        pthread_join(thread, NULL);
+        TS_ASSERT_EQUALS(ring.size(), 2u);
+        notification = ring.pop();
+        TS_ASSERT_EQUALS(notification->getName(), 1);
+        NotificationPool::release(notification);
+        notification = ring.pop();
+        TS_ASSERT_EQUALS(notification->getType(), 1);
+        NotificationPool::release(notification);
+        TS_ASSERT(ring.empty());
+    }
+};
+//--------------------------------------
+//  TimerWheel
+//--------------------------------------
+class TimerWheelTestSuite : public CxxTest::TestSuite
+{
+public:
+    void testTimersPostOnTheirTickAtEveryLevel()
+    {
+        const uint64_t start = 1000;
+        TimerWheel wheel(start);
+        NotificationQueue queue;
+        bool sooner;
+        // delays reaching every level of the wheel, named after their index
+        std::vector<unsigned long> delays;
+        unsigned long seed = 12345;
+        for(int i = 0; i < 3000; i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            delays.push_back((seed >> 8) % (i % 3 == 0 ? 300 : 20000000));
+            wheel.schedule(start, delays[i], 0, i, (void*) 0, 0, sooner);
+        }
+        Timer cancelled = wheel.schedule(start, 10, 0, -1, (void*) 0, 0, sooner);
+        TS_ASSERT(wheel.cancel(cancelled));
+        TS_ASSERT(! wheel.cancel(cancelled));
+        TS_ASSERT_EQUALS(wheel.size(), 3000u);
+        uint64_t previous = start;
+        uint64_t now = start;
+        int posted = 0;
+        while(wheel.size() != 0)
+        {
+            uint64_t expiry;
+            TS_ASSERT(wheel.nextExpiry(expiry));
+            TS_ASSERT(expiry > previous);
+            // nothing may expire before the promised tick, jump to it or past it
+            seed = seed * 1103515245 + 12345;
+            now = expiry + ((seed >> 8) % 4 == 0 ? (seed >> 12) % 100000 : 0);
+            wheel.advance(now, queue);
+            Notification* notification;
+            while((notification = queue.pop()) != (Notification*) 0)
+            {
+                int index = notification->getName();
+                TS_ASSERT(index >= 0);
+                // due no later than now, and not due before the last advance
+                uint64_t due = start + (delays[index] == 0 ? 1 : delays[index]);
+                TS_ASSERT(due <= now);
+                TS_ASSERT(due > previous);
+                NotificationPool::release(notification);
+                posted++;
+            }
+            previous = now;
+        }
+        TS_ASSERT_EQUALS(posted, 3000);
+    }
+    void testPeriodicTimersRepeatUntilCancelled()
+    {
+        TimerWheel wheel(0);
+        NotificationQueue queue;
+        bool sooner;
+        Timer every = wheel.schedule(0, 100, 100, 1, (void*) 0, 0, sooner);
+        TS_ASSERT(sooner);
+        wheel.schedule(0, 5000, 0, 2, (void*) 0, 0, sooner);
+        TS_ASSERT(! sooner);
+        TS_ASSERT_EQUALS(wheel.advance(99, queue), 0u);
+        TS_ASSERT_EQUALS(wheel.advance(1000, queue), 10u);
+        TS_ASSERT_EQUALS(wheel.advance(1050, queue), 0u);
+        TS_ASSERT(wheel.cancel(every));
+        TS_ASSERT_EQUALS(wheel.advance(4999, queue), 0u);
+        TS_ASSERT_EQUALS(wheel.advance(5000, queue), 1u);
+        TS_ASSERT_EQUALS(wheel.size(), 0u);
+        TS_ASSERT_EQUALS(queue.size(), 11u);
+    }
+};
+//--------------------------------------
 //  Facade
 //--------------------------------------
 class FacadeTestClass : public Facade
 {
 
 };
+// payloads for typed notifications
+struct SetTitle
+{
+    std::string title;
+};
+struct Resize
+{
+    int width;
+    int height;
+};
+enum SingleArgumentName { SINGLE_ARGUMENT_NAME = 445 };
+// sends a typed notification with a payload that dies when it returns
+class RetitlingCommand : public SimpleCommand
+{
+public:
+    void execute(INotification* notification)
+    {
+        SetTitle title;
+        title.title = "nested";
+        this->sendNotification<SetTitle>(title);
+        title.title = "gone";
+    }
+};
+// handles typed payloads without casts
+class TypedObject
+{
+public:
+    TypedObject() : width(0), height(0), titles(0), untypedName(0) {}
+    void setTitle(const SetTitle& payload)
+    {
+        this->title = payload.title;
+        this->titles++;
+    }
+    void resize(const Resize& payload)
+    {
+        this->width = payload.width;
+        this->height = payload.height;
+    }
+    void untyped(INotification* notification)
+    {
+        this->untypedName = notification->getName();
+    }
+    std::string title;
+    int width;
+    int height;
+    int titles;
+    int untypedName;
+};
+static void* runEventLoop(void* facade)
+{
+    ((Facade*) facade)->runEventLoop();
+    return 0;
+}
 class FacadeTestSuite : public CxxTest::TestSuite
 {
 public:
@@ -704,6 +2234,302 @@ public:
         TS_ASSERT_EQUALS(dynamic_cast<MediatorTestClass*>(this->mediator)->notifiedLastBy, 2);
         this->facade->removeMediator(this->mediatorName);
     }
+    void testSendNotificationsDeliversBatches()
+    {
+        int bulk = this->noteName + 14;
+        BatchMediator* batch = new BatchMediator(this->key + "_batch", bulk);
+        this->facade->registerMediator(batch);
+        this->get<Facade>()->registerCommand<CountedCommand>(bulk);
+        CountedCommand::executions = 0;
+        int rows[5] = { 1, 2, 3, 4, 5 };
+        void* bodies[5];
+        for(int i = 0; i < 5; i++)
+            bodies[i] = &rows[i];
+        this->facade->sendNotifications(bulk, bodies, 5, this->noteType);
+        // the mediator gets the batch at once, the command once per body
+        TS_ASSERT_EQUALS(batch->batches, 1);
+        TS_ASSERT_EQUALS(batch->sum, 15);
+        TS_ASSERT_EQUALS(batch->type, this->noteType);
+        TS_ASSERT_EQUALS(CountedCommand::executions, 5);
+        // mediators that don't override handleNotifications get them one by one
+        this->facade->registerMediator(this->mediator);
+        this->facade->sendNotifications(2, bodies, 3);
+        TS_ASSERT_EQUALS(dynamic_cast<MediatorTestClass*>(this->mediator)->notifiedLastBy, 2);
+        this->facade->removeMediator(this->mediatorName);
+        // and so do mediators that aren't Mediators
+        PlainMediator plain(this->key + "_plain", bulk);
+        this->facade->registerMediator(&plain);
+        this->facade->sendNotifications(bulk, bodies, 5);
+        TS_ASSERT_EQUALS(plain.sum, 15);
+        this->facade->removeMediator(plain.getMediatorName());
+        this->facade->removeCommand(bulk);
+        delete this->facade->removeMediator(batch->getMediatorName());
+    }
+    void testSendNotificationDoesNotAllocate()
+    {
+        this->facade->registerMediator(this->mediator);
+        this->facade->sendNotification(3, &this->noteBody, this->noteType);
+        size_t before = allocations;
+        for(int i = 0; i < 1000000; i++)
+        {
+            this->facade->sendNotification(1 + i % 4, &this->noteBody, this->noteType);
+            this->facade->sendNotification(1 + i % 4, &this->noteBody);
+            this->facade->sendNotification(1 + i % 4, this->noteType);
+            this->facade->sendNotification(1 + i % 4);
+        }
+        TS_ASSERT_EQUALS(allocations, before);
+        TS_ASSERT_EQUALS(dynamic_cast<MediatorTestClass*>(this->mediator)->notifiedLastBy, 4);
+        this->facade->removeMediator(this->mediatorName);
+    }
+    void testTypedNotificationsReachPayloadHandlers()
+    {
+        Facade* facade = this->get<Facade>();
+        TypedObject handler;
+        Subscription titles = facade->subscribe<SetTitle, TypedObject, &TypedObject::setTitle>(&handler);
+        Subscription sizes = facade->subscribe<Resize, TypedObject, &TypedObject::resize>(&handler);
+        SetTitle title;
+        title.title = "typed";
+        Resize size = { 640, 480 };
+        facade->sendNotification<SetTitle>(title);
+        facade->sendNotification<Resize>(size);
+        TS_ASSERT_EQUALS(handler.title, "typed");
+        TS_ASSERT_EQUALS(handler.width, 640);
+        TS_ASSERT_EQUALS(handler.height, 480);
+        // each payload type has a name of its own in the reserved range
+        int titleName = TypedNotification<SetTitle>::notificationName();
+        TS_ASSERT_DIFFERS(titleName, TypedNotification<Resize>::notificationName());
+        TS_ASSERT(titleName - Notification::FIRST_TYPED_NAME < Notification::MAX_TYPED_NAMES);
+        // the int-named path sees the payload as the body
+        Subscription plain = this->get<View>()->registerObserver(titleName, Delegate::bind<TypedObject, &TypedObject::untyped>(&handler));
+        size_t before = allocations;
+        facade->sendNotification<SetTitle>(title);
+        TS_ASSERT_EQUALS(allocations, before);
+        TS_ASSERT_EQUALS(handler.titles, 2);
+        TS_ASSERT_EQUALS(handler.untypedName, titleName);
+        // and a plain notification with that name reaches the typed handler
+        title.title = "untyped";
+        facade->sendNotification(titleName, &title);
+        TS_ASSERT_EQUALS(handler.title, "untyped");
+        // one argument calls still pick the int overload
+        facade->sendNotification(SINGLE_ARGUMENT_NAME);
+        facade->unsubscribe(titles);
+        facade->unsubscribe(sizes);
+        facade->unsubscribe(plain);
+        facade->sendNotification<SetTitle>(title);
+        TS_ASSERT_EQUALS(handler.titles, 3);
+    }
+    void testPostedNotificationsRunToCompletion()
+    {
+        int reposting = this->noteName + 10;
+        RepostingCommand::executions = 0;
+        this->get<Facade>()->registerCommand<RepostingCommand>(reposting);
+        this->facade->postNotification(reposting);
+        TS_ASSERT_EQUALS(RepostingCommand::executions, 0);
+        // each pump delivers one notification, the repost waits for the next
+        TS_ASSERT_EQUALS(this->facade->pump(), 1u);
+        TS_ASSERT_EQUALS(RepostingCommand::executions, 1);
+        TS_ASSERT_EQUALS(this->facade->pump(), 1u);
+        TS_ASSERT_EQUALS(this->facade->pump(), 1u);
+        TS_ASSERT_EQUALS(this->facade->pump(), 0u);
+        TS_ASSERT_EQUALS(RepostingCommand::executions, 3);
+        this->facade->removeCommand(reposting);
+    }
+    void testCoalescedPostsDeliverTheLatestBody()
+    {
+        Facade* facade = this->get<Facade>();
+        int display = this->noteName + 15;
+        int other = this->noteName + 16;
+        facade->registerCommand<LastBodyCommand>(display);
+        facade->registerCommand<CountedCommand>(other);
+        LastBodyCommand::executions = 0;
+        CountedCommand::executions = 0;
+        int frames[3] = { 1, 2, 3 };
+        facade->setCoalescing(display, Coalescing::BY_NAME);
+        facade->postNotification(display, &frames[0], 1);
+        facade->postNotification(other);
+        facade->postNotification(display, &frames[1], 2);
+        facade->postNotification(other);
+        facade->postNotification(display, &frames[2], 3);
+        TS_ASSERT_EQUALS(facade->pump(), 3u);
+        TS_ASSERT_EQUALS(LastBodyCommand::executions, 1);
+        TS_ASSERT_EQUALS(LastBodyCommand::lastBody, (void*) &frames[2]);
+        TS_ASSERT_EQUALS(LastBodyCommand::lastType, 3);
+        TS_ASSERT_EQUALS(CountedCommand::executions, 2);
+        // once delivered the next post queues again, by type if asked
+        facade->setCoalescing(display, Coalescing::BY_NAME_AND_TYPE);
+        facade->postNotification(display, &frames[0], 1);
+        facade->postNotification(display, &frames[1], 2);
+        facade->postNotification(display, &frames[2], 1);
+        TS_ASSERT_EQUALS(facade->pump(), 2u);
+        TS_ASSERT_EQUALS(LastBodyCommand::executions, 3);
+        TS_ASSERT_EQUALS(LastBodyCommand::lastBody, (void*) &frames[1]);
+        facade->setCoalescing(display, Coalescing::NONE);
+        facade->postNotification(display);
+        facade->postNotification(display);
+        TS_ASSERT_EQUALS(facade->pump(), 2u);
+        facade->removeCommand(display);
+        facade->removeCommand(other);
+    }
+    void testTimersPostFromTheEventLoop()
+    {
+        Facade* facade = this->get<Facade>();
+        int once = this->noteName + 17;
+        int every = this->noteName + 18;
+        int never = this->noteName + 19;
+        int stop = this->noteName + 20;
+        facade->registerCommand<LastBodyCommand>(once);
+        facade->registerCommand<CountedCommand>(every);
+        facade->registerCommand<SimpleTestClass>(never);
+        facade->registerCommand<StopLoopCommand>(stop);
+        LastBodyCommand::executions = 0;
+        CountedCommand::executions = 0;
+        facade->sendNotificationAfter(10, once, &this->noteBody, this->noteType);
+        Timer periodic = facade->sendNotificationEvery(5, every);
+        Timer cancelled = facade->sendNotificationAfter(20, never);
+        TS_ASSERT(facade->cancelTimer(cancelled));
+        facade->sendNotificationAfter(60, stop);
+        // sleeps between timers until the stop timer ends it
+        facade->runEventLoop();
+        TS_ASSERT_EQUALS(LastBodyCommand::executions, 1);
+        TS_ASSERT_EQUALS(LastBodyCommand::lastBody, (void*) &this->noteBody);
+        TS_ASSERT_EQUALS(LastBodyCommand::lastType, this->noteType);
+        TS_ASSERT(CountedCommand::executions >= 2);
+        TS_ASSERT_EQUALS(SimpleTestClass::executions, 0);
+        TS_ASSERT(facade->cancelTimer(periodic));
+        TS_ASSERT(! facade->cancelTimer(periodic));
+        facade->removeCommand(once);
+        facade->removeCommand(every);
+        facade->removeCommand(never);
+        facade->removeCommand(stop);
+    }
+    void testPostedPayloadsOutliveTheSender()
+    {
+        int posted = this->noteName + 13;
+        this->get<Facade>()->registerCommand<PayloadCommand>(posted);
+        LargeTracked::live = 0;
+        {
+            Payload payload;
+            payload.set(LargeTracked(42));
+            this->facade->postNotification(posted, payload);
+            TS_ASSERT(payload.empty());
+        }
+        TS_ASSERT_EQUALS(LargeTracked::live, 1);
+        TS_ASSERT_EQUALS(this->facade->pump(), 1u);
+        TS_ASSERT_EQUALS(PayloadCommand::lastValue, 42);
+        TS_ASSERT_EQUALS(PayloadCommand::liveDuringExecute, 1);
+        // freed once delivered
+        TS_ASSERT_EQUALS(LargeTracked::live, 0);
+        this->facade->removeCommand(posted);
+    }
+    void testEventLoopDeliversPostsFromAnotherThread()
+    {
+        Facade* facade = this->get<Facade>();
+        int counted = this->noteName + 11;
+        int stop = this->noteName + 12;
+        facade->registerCommand<CountedCommand>(counted);
+        facade->registerCommand<StopLoopCommand>(stop);
+        CountedCommand::executions = 0;
+        pthread_t loop;
+        pthread_create(&loop, NULL, runEventLoop, facade);
+        for(int i = 0; i < 1000; i++)
+            facade->postNotification(counted, &this->noteBody);
+        facade->postNotification(stop);
+        pthread_join(loop, NULL);
+        TS_ASSERT_EQUALS(CountedCommand::executions, 1000);
+        facade->removeCommand(counted);
+        facade->removeCommand(stop);
+    }
+    void testInboxWakesTheEventLoop()
+    {
+        Facade* facade = this->get<Facade>();
+        int counted = this->noteName + 21;
+        int stop = this->noteName + 22;
+        facade->registerCommand<CountedCommand>(counted);
+        facade->registerCommand<StopLoopCommand>(stop);
+        CountedCommand::executions = 0;
+        pthread_t loop;
+        pthread_create(&loop, NULL, runEventLoop, facade);
+        for(int i = 0; i < 5000; i++)
+        {
+            TS_ASSERT(facade->postToInbox(counted));
+            // let the loop fall asleep now and then
+            if(i % 500 == 0)
+                usleep(1000);
+        }
+        facade->postToInbox(stop);
+        pthread_join(loop, NULL);
+        TS_ASSERT_EQUALS(CountedCommand::executions, 5000);
+        TS_ASSERT_EQUALS(facade->inboxStatistics().depth, 0u);
+        TS_ASSERT_EQUALS(facade->inboxStatistics().capacity, 1024u);
+        facade->removeCommand(counted);
+        facade->removeCommand(stop);
+    }
+    void testFullBlockingInboxRefusesItsOwnCore()
+    {
+        Facade* facade = this->get<Facade>();
+        int repost = this->noteName + 26;
+        facade->registerCommand<InboxRepostingCommand>(repost);
+        facade->setInbox(2, Backpressure::BLOCK);
+        InboxRepostingCommand::refused = 0;
+        TS_ASSERT(facade->postToInbox(repost));
+        TS_ASSERT(facade->postToInbox(repost));
+        // each command fills the slot it was popped from and is refused the next
+        TS_ASSERT_EQUALS(facade->pump(), 2u);
+        TS_ASSERT_EQUALS(InboxRepostingCommand::refused, 2);
+        TS_ASSERT_EQUALS(facade->inboxStatistics().rejected, 2u);
+        TS_ASSERT_EQUALS(facade->inboxStatistics().depth, 2u);
+        facade->removeCommand(repost);
+        facade->setInbox(1024, Backpressure::BLOCK);
+        facade->pump();
+    }
+    void testRunToCompletionDefersNestedSends()
+    {
+        Facade* facade = this->get<Facade>();
+        int chain = this->noteName + 23;
+        int retitle = this->noteName + 24;
+        facade->registerCommand<ChainingCommand>(chain);
+        // by default each send nests inside the one that made it
+        ChainingCommand::length = 3;
+        ChainingCommand::maxDepth = 0;
+        ChainingCommand::order.clear();
+        facade->sendNotification(chain, 0, 1);
+        int nested[] = { 1, 2, 3, -3, -2, -1 };
+        TS_ASSERT_EQUALS(ChainingCommand::order, std::vector<int>(nested, nested + 6));
+        TS_ASSERT_EQUALS(ChainingCommand::maxDepth, 3);
+        // run to completion, each one finishes before the next starts
+        facade->setDispatchMode(DispatchMode::RUN_TO_COMPLETION);
+        ChainingCommand::maxDepth = 0;
+        ChainingCommand::order.clear();
+        facade->sendNotification(chain, 0, 1);
+        int queued[] = { 1, -1, 2, -2, 3, -3 };
+        TS_ASSERT_EQUALS(ChainingCommand::order, std::vector<int>(queued, queued + 6));
+        // however long the chain
+        ChainingCommand::length = 10000;
+        ChainingCommand::order.clear();
+        facade->sendNotification(chain, 0, 1);
+        TS_ASSERT_EQUALS(ChainingCommand::order.size(), 20000u);
+        TS_ASSERT_EQUALS(ChainingCommand::maxDepth, 1);
+        // queued typed notifications keep a copy of their payload
+        TypedObject handler;
+        Subscription titles = facade->subscribe<SetTitle, TypedObject, &TypedObject::setTitle>(&handler);
+        facade->registerCommand<RetitlingCommand>(retitle);
+        facade->sendNotification(retitle);
+        TS_ASSERT_EQUALS(handler.title, "nested");
+        TS_ASSERT_EQUALS(handler.titles, 1);
+        facade->unsubscribe(titles);
+        // a handler that throws does not leave the facade dispatching
+        int thrower = this->noteName + 25;
+        facade->registerCommand<ThrowingCommand>(thrower);
+        TS_ASSERT_THROWS(facade->sendNotification(thrower, 0, 7), int);
+        ChainingCommand::length = 3;
+        ChainingCommand::order.clear();
+        facade->sendNotification(chain, 0, 1);
+        TS_ASSERT_EQUALS(ChainingCommand::order, std::vector<int>(queued, queued + 6));
+        facade->setDispatchMode(DispatchMode::RECURSIVE);
+        facade->removeCommand(chain);
+        facade->removeCommand(retitle);
+        facade->removeCommand(thrower);
+    }
     void testCanRemoveCore()
     {
         TS_ASSERT(Facade::hasCore(this->key));
@@ -5,6 +5,7 @@
 #endif
 
 #define _CXXTEST_HAVE_STD
+#define _CXXTEST_HAVE_EH
 #include <cxxtest/TestListener.h>
 #include <cxxtest/TestTracker.h>
 #include <cxxtest/TestRunner.h>
@@ -19,289 +20,573 @@ int main() {
 static MultitonTestSuite suite_MultitonTestSuite;
 
 static CxxTest::List Tests_MultitonTestSuite = { 0, 0 };
-CxxTest::StaticSuiteDescription suiteDescription_MultitonTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 25, "MultitonTestSuite", suite_MultitonTestSuite, Tests_MultitonTestSuite );
+CxxTest::StaticSuiteDescription suiteDescription_MultitonTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 111, "MultitonTestSuite", suite_MultitonTestSuite, Tests_MultitonTestSuite );
 
 static class TestDescription_MultitonTestSuite_testCreateInstances : public CxxTest::RealTestDescription {
 public:
- TestDescription_MultitonTestSuite_testCreateInstances() : CxxTest::RealTestDescription( Tests_MultitonTestSuite, suiteDescription_MultitonTestSuite, 28, "testCreateInstances" ) {}
+ TestDescription_MultitonTestSuite_testCreateInstances() : CxxTest::RealTestDescription( Tests_MultitonTestSuite, suiteDescription_MultitonTestSuite, 114, "testCreateInstances" ) {}
  void runTest() { suite_MultitonTestSuite.testCreateInstances(); }
 } testDescription_MultitonTestSuite_testCreateInstances;
 
 static class TestDescription_MultitonTestSuite_testNumberInstances : public CxxTest::RealTestDescription {
 public:
- TestDescription_MultitonTestSuite_testNumberInstances() : CxxTest::RealTestDescription( Tests_MultitonTestSuite, suiteDescription_MultitonTestSuite, 36, "testNumberInstances" ) {}
+ TestDescription_MultitonTestSuite_testNumberInstances() : CxxTest::RealTestDescription( Tests_MultitonTestSuite, suiteDescription_MultitonTestSuite, 122, "testNumberInstances" ) {}
  void runTest() { suite_MultitonTestSuite.testNumberInstances(); }
 } testDescription_MultitonTestSuite_testNumberInstances;
 
+static class TestDescription_MultitonTestSuite_testCoreIdsIndexTheSameInstances : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MultitonTestSuite_testCoreIdsIndexTheSameInstances() : CxxTest::RealTestDescription( Tests_MultitonTestSuite, suiteDescription_MultitonTestSuite, 133, "testCoreIdsIndexTheSameInstances" ) {}
+ void runTest() { suite_MultitonTestSuite.testCoreIdsIndexTheSameInstances(); }
+} testDescription_MultitonTestSuite_testCoreIdsIndexTheSameInstances;
+
+static class TestDescription_MultitonTestSuite_testConcurrentCreationYieldsOneInstancePerKey : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MultitonTestSuite_testConcurrentCreationYieldsOneInstancePerKey() : CxxTest::RealTestDescription( Tests_MultitonTestSuite, suiteDescription_MultitonTestSuite, 150, "testConcurrentCreationYieldsOneInstancePerKey" ) {}
+ void runTest() { suite_MultitonTestSuite.testConcurrentCreationYieldsOneInstancePerKey(); }
+} testDescription_MultitonTestSuite_testConcurrentCreationYieldsOneInstancePerKey;
+
+static class TestDescription_MultitonTestSuite_testConcurrentCoresAreSetUpBeforeTheyAreShared : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MultitonTestSuite_testConcurrentCoresAreSetUpBeforeTheyAreShared() : CxxTest::RealTestDescription( Tests_MultitonTestSuite, suiteDescription_MultitonTestSuite, 167, "testConcurrentCoresAreSetUpBeforeTheyAreShared" ) {}
+ void runTest() { suite_MultitonTestSuite.testConcurrentCoresAreSetUpBeforeTheyAreShared(); }
+} testDescription_MultitonTestSuite_testConcurrentCoresAreSetUpBeforeTheyAreShared;
+
 static NotificationTestSuite suite_NotificationTestSuite;
 
 static CxxTest::List Tests_NotificationTestSuite = { 0, 0 };
-CxxTest::StaticSuiteDescription suiteDescription_NotificationTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 51, "NotificationTestSuite", suite_NotificationTestSuite, Tests_NotificationTestSuite );
+CxxTest::StaticSuiteDescription suiteDescription_NotificationTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 227, "NotificationTestSuite", suite_NotificationTestSuite, Tests_NotificationTestSuite );
 
 static class TestDescription_NotificationTestSuite_testConstructorSets_name_type : public CxxTest::RealTestDescription {
 public:
- TestDescription_NotificationTestSuite_testConstructorSets_name_type() : CxxTest::RealTestDescription( Tests_NotificationTestSuite, suiteDescription_NotificationTestSuite, 61, "testConstructorSets_name_type" ) {}
+ TestDescription_NotificationTestSuite_testConstructorSets_name_type() : CxxTest::RealTestDescription( Tests_NotificationTestSuite, suiteDescription_NotificationTestSuite, 237, "testConstructorSets_name_type" ) {}
  void runTest() { suite_NotificationTestSuite.testConstructorSets_name_type(); }
 } testDescription_NotificationTestSuite_testConstructorSets_name_type;
 
+static class TestDescription_NotificationTestSuite_testPayloadsAreDestroyedExactlyOnce : public CxxTest::RealTestDescription {
+public:
+ TestDescription_NotificationTestSuite_testPayloadsAreDestroyedExactlyOnce() : CxxTest::RealTestDescription( Tests_NotificationTestSuite, suiteDescription_NotificationTestSuite, 244, "testPayloadsAreDestroyedExactlyOnce" ) {}
+ void runTest() { suite_NotificationTestSuite.testPayloadsAreDestroyedExactlyOnce(); }
+} testDescription_NotificationTestSuite_testPayloadsAreDestroyedExactlyOnce;
+
+static class TestDescription_NotificationTestSuite_testCopiesOwnTheirPayloads : public CxxTest::RealTestDescription {
+public:
+ TestDescription_NotificationTestSuite_testCopiesOwnTheirPayloads() : CxxTest::RealTestDescription( Tests_NotificationTestSuite, suiteDescription_NotificationTestSuite, 284, "testCopiesOwnTheirPayloads" ) {}
+ void runTest() { suite_NotificationTestSuite.testCopiesOwnTheirPayloads(); }
+} testDescription_NotificationTestSuite_testCopiesOwnTheirPayloads;
+
 static MacroCommandTestSuite suite_MacroCommandTestSuite;
 
 static CxxTest::List Tests_MacroCommandTestSuite = { 0, 0 };
-CxxTest::StaticSuiteDescription suiteDescription_MacroCommandTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 109, "MacroCommandTestSuite", suite_MacroCommandTestSuite, Tests_MacroCommandTestSuite );
+CxxTest::StaticSuiteDescription suiteDescription_MacroCommandTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 499, "MacroCommandTestSuite", suite_MacroCommandTestSuite, Tests_MacroCommandTestSuite );
 
 static class TestDescription_MacroCommandTestSuite_testAdd_addSubCommand_IncrementsCommandVector : public CxxTest::RealTestDescription {
 public:
- TestDescription_MacroCommandTestSuite_testAdd_addSubCommand_IncrementsCommandVector() : CxxTest::RealTestDescription( Tests_MacroCommandTestSuite, suiteDescription_MacroCommandTestSuite, 116, "testAdd_addSubCommand_IncrementsCommandVector" ) {}
+ TestDescription_MacroCommandTestSuite_testAdd_addSubCommand_IncrementsCommandVector() : CxxTest::RealTestDescription( Tests_MacroCommandTestSuite, suiteDescription_MacroCommandTestSuite, 506, "testAdd_addSubCommand_IncrementsCommandVector" ) {}
  void runTest() { suite_MacroCommandTestSuite.testAdd_addSubCommand_IncrementsCommandVector(); }
 } testDescription_MacroCommandTestSuite_testAdd_addSubCommand_IncrementsCommandVector;
 
 static class TestDescription_MacroCommandTestSuite_testExecuteShouldExecAllSubCommands : public CxxTest::RealTestDescription {
 public:
- TestDescription_MacroCommandTestSuite_testExecuteShouldExecAllSubCommands() : CxxTest::RealTestDescription( Tests_MacroCommandTestSuite, suiteDescription_MacroCommandTestSuite, 120, "testExecuteShouldExecAllSubCommands" ) {}
+ TestDescription_MacroCommandTestSuite_testExecuteShouldExecAllSubCommands() : CxxTest::RealTestDescription( Tests_MacroCommandTestSuite, suiteDescription_MacroCommandTestSuite, 510, "testExecuteShouldExecAllSubCommands" ) {}
  void runTest() { suite_MacroCommandTestSuite.testExecuteShouldExecAllSubCommands(); }
 } testDescription_MacroCommandTestSuite_testExecuteShouldExecAllSubCommands;
 
 static NotifierTestSuite suite_NotifierTestSuite;
 
 static CxxTest::List Tests_NotifierTestSuite = { 0, 0 };
-CxxTest::StaticSuiteDescription suiteDescription_NotifierTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 131, "NotifierTestSuite", suite_NotifierTestSuite, Tests_NotifierTestSuite );
+CxxTest::StaticSuiteDescription suiteDescription_NotifierTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 545, "NotifierTestSuite", suite_NotifierTestSuite, Tests_NotifierTestSuite );
 
 static class TestDescription_NotifierTestSuite_testCanInitializeNotifier : public CxxTest::RealTestDescription {
 public:
- TestDescription_NotifierTestSuite_testCanInitializeNotifier() : CxxTest::RealTestDescription( Tests_NotifierTestSuite, suiteDescription_NotifierTestSuite, 148, "testCanInitializeNotifier" ) {}
+ TestDescription_NotifierTestSuite_testCanInitializeNotifier() : CxxTest::RealTestDescription( Tests_NotifierTestSuite, suiteDescription_NotifierTestSuite, 562, "testCanInitializeNotifier" ) {}
  void runTest() { suite_NotifierTestSuite.testCanInitializeNotifier(); }
 } testDescription_NotifierTestSuite_testCanInitializeNotifier;
 
 static class TestDescription_NotifierTestSuite_testCanSendNotification : public CxxTest::RealTestDescription {
 public:
- TestDescription_NotifierTestSuite_testCanSendNotification() : CxxTest::RealTestDescription( Tests_NotifierTestSuite, suiteDescription_NotifierTestSuite, 152, "testCanSendNotification" ) {}
+ TestDescription_NotifierTestSuite_testCanSendNotification() : CxxTest::RealTestDescription( Tests_NotifierTestSuite, suiteDescription_NotifierTestSuite, 566, "testCanSendNotification" ) {}
  void runTest() { suite_NotifierTestSuite.testCanSendNotification(); }
 } testDescription_NotifierTestSuite_testCanSendNotification;
 
+static class TestDescription_NotifierTestSuite_testSendNotificationUsesCachedFacade : public CxxTest::RealTestDescription {
+public:
+ TestDescription_NotifierTestSuite_testSendNotificationUsesCachedFacade() : CxxTest::RealTestDescription( Tests_NotifierTestSuite, suiteDescription_NotifierTestSuite, 574, "testSendNotificationUsesCachedFacade" ) {}
+ void runTest() { suite_NotifierTestSuite.testSendNotificationUsesCachedFacade(); }
+} testDescription_NotifierTestSuite_testSendNotificationUsesCachedFacade;
+
+static class TestDescription_NotifierTestSuite_testRemovingCoreDropsCachedFacade : public CxxTest::RealTestDescription {
+public:
+ TestDescription_NotifierTestSuite_testRemovingCoreDropsCachedFacade() : CxxTest::RealTestDescription( Tests_NotifierTestSuite, suiteDescription_NotifierTestSuite, 582, "testRemovingCoreDropsCachedFacade" ) {}
+ void runTest() { suite_NotifierTestSuite.testRemovingCoreDropsCachedFacade(); }
+} testDescription_NotifierTestSuite_testRemovingCoreDropsCachedFacade;
+
+static class TestDescription_NotifierTestSuite_testThreadsShareANotifiersCachedFacade : public CxxTest::RealTestDescription {
+public:
+ TestDescription_NotifierTestSuite_testThreadsShareANotifiersCachedFacade() : CxxTest::RealTestDescription( Tests_NotifierTestSuite, suiteDescription_NotifierTestSuite, 592, "testThreadsShareANotifiersCachedFacade" ) {}
+ void runTest() { suite_NotifierTestSuite.testThreadsShareANotifiersCachedFacade(); }
+} testDescription_NotifierTestSuite_testThreadsShareANotifiersCachedFacade;
+
 static ObserverTestSuite suite_ObserverTestSuite;
 
 static CxxTest::List Tests_ObserverTestSuite = { 0, 0 };
-CxxTest::StaticSuiteDescription suiteDescription_ObserverTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 193, "ObserverTestSuite", suite_ObserverTestSuite, Tests_ObserverTestSuite );
+CxxTest::StaticSuiteDescription suiteDescription_ObserverTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 679, "ObserverTestSuite", suite_ObserverTestSuite, Tests_ObserverTestSuite );
 
 static class TestDescription_ObserverTestSuite_testObserverConstructorShouldSetNotifyMethodAndNotifyContext : public CxxTest::RealTestDescription {
 public:
- TestDescription_ObserverTestSuite_testObserverConstructorShouldSetNotifyMethodAndNotifyContext() : CxxTest::RealTestDescription( Tests_ObserverTestSuite, suiteDescription_ObserverTestSuite, 204, "testObserverConstructorShouldSetNotifyMethodAndNotifyContext" ) {}
+ TestDescription_ObserverTestSuite_testObserverConstructorShouldSetNotifyMethodAndNotifyContext() : CxxTest::RealTestDescription( Tests_ObserverTestSuite, suiteDescription_ObserverTestSuite, 690, "testObserverConstructorShouldSetNotifyMethodAndNotifyContext" ) {}
  void runTest() { suite_ObserverTestSuite.testObserverConstructorShouldSetNotifyMethodAndNotifyContext(); }
 } testDescription_ObserverTestSuite_testObserverConstructorShouldSetNotifyMethodAndNotifyContext;
 
 static class TestDescription_ObserverTestSuite_testCanNotifyInterestedObject : public CxxTest::RealTestDescription {
 public:
- TestDescription_ObserverTestSuite_testCanNotifyInterestedObject() : CxxTest::RealTestDescription( Tests_ObserverTestSuite, suiteDescription_ObserverTestSuite, 209, "testCanNotifyInterestedObject" ) {}
+ TestDescription_ObserverTestSuite_testCanNotifyInterestedObject() : CxxTest::RealTestDescription( Tests_ObserverTestSuite, suiteDescription_ObserverTestSuite, 695, "testCanNotifyInterestedObject" ) {}
  void runTest() { suite_ObserverTestSuite.testCanNotifyInterestedObject(); }
 } testDescription_ObserverTestSuite_testCanNotifyInterestedObject;
 
 static class TestDescription_ObserverTestSuite_testCanCompareContexts : public CxxTest::RealTestDescription {
 public:
- TestDescription_ObserverTestSuite_testCanCompareContexts() : CxxTest::RealTestDescription( Tests_ObserverTestSuite, suiteDescription_ObserverTestSuite, 214, "testCanCompareContexts" ) {}
+ TestDescription_ObserverTestSuite_testCanCompareContexts() : CxxTest::RealTestDescription( Tests_ObserverTestSuite, suiteDescription_ObserverTestSuite, 700, "testCanCompareContexts" ) {}
  void runTest() { suite_ObserverTestSuite.testCanCompareContexts(); }
 } testDescription_ObserverTestSuite_testCanCompareContexts;
 
+static class TestDescription_ObserverTestSuite_testDelegatesCallBoundMembersAndObservers : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ObserverTestSuite_testDelegatesCallBoundMembersAndObservers() : CxxTest::RealTestDescription( Tests_ObserverTestSuite, suiteDescription_ObserverTestSuite, 706, "testDelegatesCallBoundMembersAndObservers" ) {}
+ void runTest() { suite_ObserverTestSuite.testDelegatesCallBoundMembersAndObservers(); }
+} testDescription_ObserverTestSuite_testDelegatesCallBoundMembersAndObservers;
+
 static ProxyTestSuite suite_ProxyTestSuite;
 
 static CxxTest::List Tests_ProxyTestSuite = { 0, 0 };
-CxxTest::StaticSuiteDescription suiteDescription_ProxyTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 265, "ProxyTestSuite", suite_ProxyTestSuite, Tests_ProxyTestSuite );
+CxxTest::StaticSuiteDescription suiteDescription_ProxyTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 927, "ProxyTestSuite", suite_ProxyTestSuite, Tests_ProxyTestSuite );
 
 static class TestDescription_ProxyTestSuite_testConstructorCanInitializeData : public CxxTest::RealTestDescription {
 public:
- TestDescription_ProxyTestSuite_testConstructorCanInitializeData() : CxxTest::RealTestDescription( Tests_ProxyTestSuite, suiteDescription_ProxyTestSuite, 268, "testConstructorCanInitializeData" ) {}
+ TestDescription_ProxyTestSuite_testConstructorCanInitializeData() : CxxTest::RealTestDescription( Tests_ProxyTestSuite, suiteDescription_ProxyTestSuite, 930, "testConstructorCanInitializeData" ) {}
  void runTest() { suite_ProxyTestSuite.testConstructorCanInitializeData(); }
 } testDescription_ProxyTestSuite_testConstructorCanInitializeData;
 
 static class TestDescription_ProxyTestSuite_testCanSetAndGetData : public CxxTest::RealTestDescription {
 public:
- TestDescription_ProxyTestSuite_testCanSetAndGetData() : CxxTest::RealTestDescription( Tests_ProxyTestSuite, suiteDescription_ProxyTestSuite, 274, "testCanSetAndGetData" ) {}
+ TestDescription_ProxyTestSuite_testCanSetAndGetData() : CxxTest::RealTestDescription( Tests_ProxyTestSuite, suiteDescription_ProxyTestSuite, 936, "testCanSetAndGetData" ) {}
  void runTest() { suite_ProxyTestSuite.testCanSetAndGetData(); }
 } testDescription_ProxyTestSuite_testCanSetAndGetData;
 
 static class TestDescription_ProxyTestSuite_testRegisterCallsDerivedClassMember : public CxxTest::RealTestDescription {
 public:
- TestDescription_ProxyTestSuite_testRegisterCallsDerivedClassMember() : CxxTest::RealTestDescription( Tests_ProxyTestSuite, suiteDescription_ProxyTestSuite, 295, "testRegisterCallsDerivedClassMember" ) {}
+ TestDescription_ProxyTestSuite_testRegisterCallsDerivedClassMember() : CxxTest::RealTestDescription( Tests_ProxyTestSuite, suiteDescription_ProxyTestSuite, 957, "testRegisterCallsDerivedClassMember" ) {}
  void runTest() { suite_ProxyTestSuite.testRegisterCallsDerivedClassMember(); }
 } testDescription_ProxyTestSuite_testRegisterCallsDerivedClassMember;
 
+static class TestDescription_ProxyTestSuite_testVersionedProxiesPublishWholeSnapshots : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ProxyTestSuite_testVersionedProxiesPublishWholeSnapshots() : CxxTest::RealTestDescription( Tests_ProxyTestSuite, suiteDescription_ProxyTestSuite, 965, "testVersionedProxiesPublishWholeSnapshots" ) {}
+ void runTest() { suite_ProxyTestSuite.testVersionedProxiesPublishWholeSnapshots(); }
+} testDescription_ProxyTestSuite_testVersionedProxiesPublishWholeSnapshots;
+
+static class TestDescription_ProxyTestSuite_testSnapshotsKeepTheirVersionAlive : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ProxyTestSuite_testSnapshotsKeepTheirVersionAlive() : CxxTest::RealTestDescription( Tests_ProxyTestSuite, suiteDescription_ProxyTestSuite, 1001, "testSnapshotsKeepTheirVersionAlive" ) {}
+ void runTest() { suite_ProxyTestSuite.testSnapshotsKeepTheirVersionAlive(); }
+} testDescription_ProxyTestSuite_testSnapshotsKeepTheirVersionAlive;
+
 static MediatorTestSuite suite_MediatorTestSuite;
 
 static CxxTest::List Tests_MediatorTestSuite = { 0, 0 };
-CxxTest::StaticSuiteDescription suiteDescription_MediatorTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 367, "MediatorTestSuite", suite_MediatorTestSuite, Tests_MediatorTestSuite );
+CxxTest::StaticSuiteDescription suiteDescription_MediatorTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 1159, "MediatorTestSuite", suite_MediatorTestSuite, Tests_MediatorTestSuite );
 
 static class TestDescription_MediatorTestSuite_testConstructorSetsNameAndViewComponent : public CxxTest::RealTestDescription {
 public:
- TestDescription_MediatorTestSuite_testConstructorSetsNameAndViewComponent() : CxxTest::RealTestDescription( Tests_MediatorTestSuite, suiteDescription_MediatorTestSuite, 375, "testConstructorSetsNameAndViewComponent" ) {}
+ TestDescription_MediatorTestSuite_testConstructorSetsNameAndViewComponent() : CxxTest::RealTestDescription( Tests_MediatorTestSuite, suiteDescription_MediatorTestSuite, 1167, "testConstructorSetsNameAndViewComponent" ) {}
  void runTest() { suite_MediatorTestSuite.testConstructorSetsNameAndViewComponent(); }
 } testDescription_MediatorTestSuite_testConstructorSetsNameAndViewComponent;
 
 static class TestDescription_MediatorTestSuite_testCanGetNotificationInterests : public CxxTest::RealTestDescription {
 public:
- TestDescription_MediatorTestSuite_testCanGetNotificationInterests() : CxxTest::RealTestDescription( Tests_MediatorTestSuite, suiteDescription_MediatorTestSuite, 381, "testCanGetNotificationInterests" ) {}
+ TestDescription_MediatorTestSuite_testCanGetNotificationInterests() : CxxTest::RealTestDescription( Tests_MediatorTestSuite, suiteDescription_MediatorTestSuite, 1173, "testCanGetNotificationInterests" ) {}
  void runTest() { suite_MediatorTestSuite.testCanGetNotificationInterests(); }
 } testDescription_MediatorTestSuite_testCanGetNotificationInterests;
 
 static class TestDescription_MediatorTestSuite_testViewComponentPointsToOriginalMemoryAddress : public CxxTest::RealTestDescription {
 public:
- TestDescription_MediatorTestSuite_testViewComponentPointsToOriginalMemoryAddress() : CxxTest::RealTestDescription( Tests_MediatorTestSuite, suiteDescription_MediatorTestSuite, 387, "testViewComponentPointsToOriginalMemoryAddress" ) {}
+ TestDescription_MediatorTestSuite_testViewComponentPointsToOriginalMemoryAddress() : CxxTest::RealTestDescription( Tests_MediatorTestSuite, suiteDescription_MediatorTestSuite, 1179, "testViewComponentPointsToOriginalMemoryAddress" ) {}
  void runTest() { suite_MediatorTestSuite.testViewComponentPointsToOriginalMemoryAddress(); }
 } testDescription_MediatorTestSuite_testViewComponentPointsToOriginalMemoryAddress;
 
 static class TestDescription_MediatorTestSuite_testViewComponentPersistsAfterScope : public CxxTest::RealTestDescription {
 public:
- TestDescription_MediatorTestSuite_testViewComponentPersistsAfterScope() : CxxTest::RealTestDescription( Tests_MediatorTestSuite, suiteDescription_MediatorTestSuite, 405, "testViewComponentPersistsAfterScope" ) {}
+ TestDescription_MediatorTestSuite_testViewComponentPersistsAfterScope() : CxxTest::RealTestDescription( Tests_MediatorTestSuite, suiteDescription_MediatorTestSuite, 1197, "testViewComponentPersistsAfterScope" ) {}
  void runTest() { suite_MediatorTestSuite.testViewComponentPersistsAfterScope(); }
 } testDescription_MediatorTestSuite_testViewComponentPersistsAfterScope;
 
 static ViewTestSuite suite_ViewTestSuite;
 
 static CxxTest::List Tests_ViewTestSuite = { 0, 0 };
-CxxTest::StaticSuiteDescription suiteDescription_ViewTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 420, "ViewTestSuite", suite_ViewTestSuite, Tests_ViewTestSuite );
+CxxTest::StaticSuiteDescription suiteDescription_ViewTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 1212, "ViewTestSuite", suite_ViewTestSuite, Tests_ViewTestSuite );
 
 static class TestDescription_ViewTestSuite_testMultitonKeyIsSet : public CxxTest::RealTestDescription {
 public:
- TestDescription_ViewTestSuite_testMultitonKeyIsSet() : CxxTest::RealTestDescription( Tests_ViewTestSuite, suiteDescription_ViewTestSuite, 438, "testMultitonKeyIsSet" ) {}
+ TestDescription_ViewTestSuite_testMultitonKeyIsSet() : CxxTest::RealTestDescription( Tests_ViewTestSuite, suiteDescription_ViewTestSuite, 1230, "testMultitonKeyIsSet" ) {}
  void runTest() { suite_ViewTestSuite.testMultitonKeyIsSet(); }
 } testDescription_ViewTestSuite_testMultitonKeyIsSet;
 
 static class TestDescription_ViewTestSuite_testCanRegisterAndNotifyAndRemoveObserver : public CxxTest::RealTestDescription {
 public:
- TestDescription_ViewTestSuite_testCanRegisterAndNotifyAndRemoveObserver() : CxxTest::RealTestDescription( Tests_ViewTestSuite, suiteDescription_ViewTestSuite, 442, "testCanRegisterAndNotifyAndRemoveObserver" ) {}
+ TestDescription_ViewTestSuite_testCanRegisterAndNotifyAndRemoveObserver() : CxxTest::RealTestDescription( Tests_ViewTestSuite, suiteDescription_ViewTestSuite, 1234, "testCanRegisterAndNotifyAndRemoveObserver" ) {}
  void runTest() { suite_ViewTestSuite.testCanRegisterAndNotifyAndRemoveObserver(); }
 } testDescription_ViewTestSuite_testCanRegisterAndNotifyAndRemoveObserver;
 
+static class TestDescription_ViewTestSuite_testCanNotifyDenseAndSparseNames : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ViewTestSuite_testCanNotifyDenseAndSparseNames() : CxxTest::RealTestDescription( Tests_ViewTestSuite, suiteDescription_ViewTestSuite, 1245, "testCanNotifyDenseAndSparseNames" ) {}
+ void runTest() { suite_ViewTestSuite.testCanNotifyDenseAndSparseNames(); }
+} testDescription_ViewTestSuite_testCanNotifyDenseAndSparseNames;
+
+static class TestDescription_ViewTestSuite_testCanRemoveObserverBySubscription : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ViewTestSuite_testCanRemoveObserverBySubscription() : CxxTest::RealTestDescription( Tests_ViewTestSuite, suiteDescription_ViewTestSuite, 1267, "testCanRemoveObserverBySubscription" ) {}
+ void runTest() { suite_ViewTestSuite.testCanRemoveObserverBySubscription(); }
+} testDescription_ViewTestSuite_testCanRemoveObserverBySubscription;
+
+static class TestDescription_ViewTestSuite_testObserverListsRecoverFromAThrowingObserver : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ViewTestSuite_testObserverListsRecoverFromAThrowingObserver() : CxxTest::RealTestDescription( Tests_ViewTestSuite, suiteDescription_ViewTestSuite, 1301, "testObserverListsRecoverFromAThrowingObserver" ) {}
+ void runTest() { suite_ViewTestSuite.testObserverListsRecoverFromAThrowingObserver(); }
+} testDescription_ViewTestSuite_testObserverListsRecoverFromAThrowingObserver;
+
+static class TestDescription_ViewTestSuite_testObserversCanMutateListDuringNotification : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ViewTestSuite_testObserversCanMutateListDuringNotification() : CxxTest::RealTestDescription( Tests_ViewTestSuite, suiteDescription_ViewTestSuite, 1320, "testObserversCanMutateListDuringNotification" ) {}
+ void runTest() { suite_ViewTestSuite.testObserversCanMutateListDuringNotification(); }
+} testDescription_ViewTestSuite_testObserversCanMutateListDuringNotification;
+
 static class TestDescription_ViewTestSuite_testCanRegisterAndRetrieveMediator : public CxxTest::RealTestDescription {
 public:
- TestDescription_ViewTestSuite_testCanRegisterAndRetrieveMediator() : CxxTest::RealTestDescription( Tests_ViewTestSuite, suiteDescription_ViewTestSuite, 453, "testCanRegisterAndRetrieveMediator" ) {}
+ TestDescription_ViewTestSuite_testCanRegisterAndRetrieveMediator() : CxxTest::RealTestDescription( Tests_ViewTestSuite, suiteDescription_ViewTestSuite, 1339, "testCanRegisterAndRetrieveMediator" ) {}
  void runTest() { suite_ViewTestSuite.testCanRegisterAndRetrieveMediator(); }
 } testDescription_ViewTestSuite_testCanRegisterAndRetrieveMediator;
 
 static class TestDescription_ViewTestSuite_testRegisteredMediatorRecievesNotificationAndRemovingMediatorRemovesObservers : public CxxTest::RealTestDescription {
 public:
- TestDescription_ViewTestSuite_testRegisteredMediatorRecievesNotificationAndRemovingMediatorRemovesObservers() : CxxTest::RealTestDescription( Tests_ViewTestSuite, suiteDescription_ViewTestSuite, 463, "testRegisteredMediatorRecievesNotificationAndRemovingMediatorRemovesObservers" ) {}
+ TestDescription_ViewTestSuite_testRegisteredMediatorRecievesNotificationAndRemovingMediatorRemovesObservers() : CxxTest::RealTestDescription( Tests_ViewTestSuite, suiteDescription_ViewTestSuite, 1349, "testRegisteredMediatorRecievesNotificationAndRemovingMediatorRemovesObservers" ) {}
  void runTest() { suite_ViewTestSuite.testRegisteredMediatorRecievesNotificationAndRemovingMediatorRemovesObservers(); }
 } testDescription_ViewTestSuite_testRegisteredMediatorRecievesNotificationAndRemovingMediatorRemovesObservers;
 
 static class TestDescription_ViewTestSuite_testCanRetrieveMediator : public CxxTest::RealTestDescription {
 public:
- TestDescription_ViewTestSuite_testCanRetrieveMediator() : CxxTest::RealTestDescription( Tests_ViewTestSuite, suiteDescription_ViewTestSuite, 473, "testCanRetrieveMediator" ) {}
+ TestDescription_ViewTestSuite_testCanRetrieveMediator() : CxxTest::RealTestDescription( Tests_ViewTestSuite, suiteDescription_ViewTestSuite, 1359, "testCanRetrieveMediator" ) {}
  void runTest() { suite_ViewTestSuite.testCanRetrieveMediator(); }
 } testDescription_ViewTestSuite_testCanRetrieveMediator;
 
 static class TestDescription_ViewTestSuite_testCanRemoveView : public CxxTest::RealTestDescription {
 public:
- TestDescription_ViewTestSuite_testCanRemoveView() : CxxTest::RealTestDescription( Tests_ViewTestSuite, suiteDescription_ViewTestSuite, 479, "testCanRemoveView" ) {}
+ TestDescription_ViewTestSuite_testCanRemoveView() : CxxTest::RealTestDescription( Tests_ViewTestSuite, suiteDescription_ViewTestSuite, 1365, "testCanRemoveView" ) {}
  void runTest() { suite_ViewTestSuite.testCanRemoveView(); }
 } testDescription_ViewTestSuite_testCanRemoveView;
 
 static ModelTestSuite suite_ModelTestSuite;
 
 static CxxTest::List Tests_ModelTestSuite = { 0, 0 };
-CxxTest::StaticSuiteDescription suiteDescription_ModelTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 510, "ModelTestSuite", suite_ModelTestSuite, Tests_ModelTestSuite );
+CxxTest::StaticSuiteDescription suiteDescription_ModelTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 1396, "ModelTestSuite", suite_ModelTestSuite, Tests_ModelTestSuite );
 
 static class TestDescription_ModelTestSuite_testMultitonKeyIsSet : public CxxTest::RealTestDescription {
 public:
- TestDescription_ModelTestSuite_testMultitonKeyIsSet() : CxxTest::RealTestDescription( Tests_ModelTestSuite, suiteDescription_ModelTestSuite, 521, "testMultitonKeyIsSet" ) {}
+ TestDescription_ModelTestSuite_testMultitonKeyIsSet() : CxxTest::RealTestDescription( Tests_ModelTestSuite, suiteDescription_ModelTestSuite, 1407, "testMultitonKeyIsSet" ) {}
  void runTest() { suite_ModelTestSuite.testMultitonKeyIsSet(); }
 } testDescription_ModelTestSuite_testMultitonKeyIsSet;
 
 static class TestDescription_ModelTestSuite_testCanRegisterAndRetrieveAndRemoveProxy : public CxxTest::RealTestDescription {
 public:
- TestDescription_ModelTestSuite_testCanRegisterAndRetrieveAndRemoveProxy() : CxxTest::RealTestDescription( Tests_ModelTestSuite, suiteDescription_ModelTestSuite, 525, "testCanRegisterAndRetrieveAndRemoveProxy" ) {}
+ TestDescription_ModelTestSuite_testCanRegisterAndRetrieveAndRemoveProxy() : CxxTest::RealTestDescription( Tests_ModelTestSuite, suiteDescription_ModelTestSuite, 1411, "testCanRegisterAndRetrieveAndRemoveProxy" ) {}
  void runTest() { suite_ModelTestSuite.testCanRegisterAndRetrieveAndRemoveProxy(); }
 } testDescription_ModelTestSuite_testCanRegisterAndRetrieveAndRemoveProxy;
 
+static class TestDescription_ModelTestSuite_testLookingUpMissingProxiesRegistersNothing : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ModelTestSuite_testLookingUpMissingProxiesRegistersNothing() : CxxTest::RealTestDescription( Tests_ModelTestSuite, suiteDescription_ModelTestSuite, 1426, "testLookingUpMissingProxiesRegistersNothing" ) {}
+ void runTest() { suite_ModelTestSuite.testLookingUpMissingProxiesRegistersNothing(); }
+} testDescription_ModelTestSuite_testLookingUpMissingProxiesRegistersNothing;
+
+static class TestDescription_ModelTestSuite_testLazyProxiesAreConstructedOnceOnFirstRetrieval : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ModelTestSuite_testLazyProxiesAreConstructedOnceOnFirstRetrieval() : CxxTest::RealTestDescription( Tests_ModelTestSuite, suiteDescription_ModelTestSuite, 1453, "testLazyProxiesAreConstructedOnceOnFirstRetrieval" ) {}
+ void runTest() { suite_ModelTestSuite.testLazyProxiesAreConstructedOnceOnFirstRetrieval(); }
+} testDescription_ModelTestSuite_testLazyProxiesAreConstructedOnceOnFirstRetrieval;
+
+static class TestDescription_ModelTestSuite_testRegisterProxiesHonorsDependencies : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ModelTestSuite_testRegisterProxiesHonorsDependencies() : CxxTest::RealTestDescription( Tests_ModelTestSuite, suiteDescription_ModelTestSuite, 1488, "testRegisterProxiesHonorsDependencies" ) {}
+ void runTest() { suite_ModelTestSuite.testRegisterProxiesHonorsDependencies(); }
+} testDescription_ModelTestSuite_testRegisterProxiesHonorsDependencies;
+
+static class TestDescription_ModelTestSuite_testBatchesMayRetrieveLazyProxiesThatRegisterMore : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ModelTestSuite_testBatchesMayRetrieveLazyProxiesThatRegisterMore() : CxxTest::RealTestDescription( Tests_ModelTestSuite, suiteDescription_ModelTestSuite, 1550, "testBatchesMayRetrieveLazyProxiesThatRegisterMore" ) {}
+ void runTest() { suite_ModelTestSuite.testBatchesMayRetrieveLazyProxiesThatRegisterMore(); }
+} testDescription_ModelTestSuite_testBatchesMayRetrieveLazyProxiesThatRegisterMore;
+
+static class TestDescription_ModelTestSuite_testProxyRefsFollowTheirRegistration : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ModelTestSuite_testProxyRefsFollowTheirRegistration() : CxxTest::RealTestDescription( Tests_ModelTestSuite, suiteDescription_ModelTestSuite, 1592, "testProxyRefsFollowTheirRegistration" ) {}
+ void runTest() { suite_ModelTestSuite.testProxyRefsFollowTheirRegistration(); }
+} testDescription_ModelTestSuite_testProxyRefsFollowTheirRegistration;
+
+static class TestDescription_ModelTestSuite_testLazyProxiesMayRegisterProxiesWhileOthersRetrieve : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ModelTestSuite_testLazyProxiesMayRegisterProxiesWhileOthersRetrieve() : CxxTest::RealTestDescription( Tests_ModelTestSuite, suiteDescription_ModelTestSuite, 1612, "testLazyProxiesMayRegisterProxiesWhileOthersRetrieve" ) {}
+ void runTest() { suite_ModelTestSuite.testLazyProxiesMayRegisterProxiesWhileOthersRetrieve(); }
+} testDescription_ModelTestSuite_testLazyProxiesMayRegisterProxiesWhileOthersRetrieve;
+
 static class TestDescription_ModelTestSuite_testCanRemoveModel : public CxxTest::RealTestDescription {
 public:
- TestDescription_ModelTestSuite_testCanRemoveModel() : CxxTest::RealTestDescription( Tests_ModelTestSuite, suiteDescription_ModelTestSuite, 540, "testCanRemoveModel" ) {}
+ TestDescription_ModelTestSuite_testCanRemoveModel() : CxxTest::RealTestDescription( Tests_ModelTestSuite, suiteDescription_ModelTestSuite, 1668, "testCanRemoveModel" ) {}
  void runTest() { suite_ModelTestSuite.testCanRemoveModel(); }
 } testDescription_ModelTestSuite_testCanRemoveModel;
 
 static ControllerTestSuite suite_ControllerTestSuite;
 
 static CxxTest::List Tests_ControllerTestSuite = { 0, 0 };
-CxxTest::StaticSuiteDescription suiteDescription_ControllerTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 566, "ControllerTestSuite", suite_ControllerTestSuite, Tests_ControllerTestSuite );
+CxxTest::StaticSuiteDescription suiteDescription_ControllerTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 1694, "ControllerTestSuite", suite_ControllerTestSuite, Tests_ControllerTestSuite );
 
 static class TestDescription_ControllerTestSuite_testCanGetControllerInstance : public CxxTest::RealTestDescription {
 public:
- TestDescription_ControllerTestSuite_testCanGetControllerInstance() : CxxTest::RealTestDescription( Tests_ControllerTestSuite, suiteDescription_ControllerTestSuite, 580, "testCanGetControllerInstance" ) {}
+ TestDescription_ControllerTestSuite_testCanGetControllerInstance() : CxxTest::RealTestDescription( Tests_ControllerTestSuite, suiteDescription_ControllerTestSuite, 1708, "testCanGetControllerInstance" ) {}
  void runTest() { suite_ControllerTestSuite.testCanGetControllerInstance(); }
 } testDescription_ControllerTestSuite_testCanGetControllerInstance;
 
 static class TestDescription_ControllerTestSuite_testMultitonKeyIsSet : public CxxTest::RealTestDescription {
 public:
- TestDescription_ControllerTestSuite_testMultitonKeyIsSet() : CxxTest::RealTestDescription( Tests_ControllerTestSuite, suiteDescription_ControllerTestSuite, 586, "testMultitonKeyIsSet" ) {}
+ TestDescription_ControllerTestSuite_testMultitonKeyIsSet() : CxxTest::RealTestDescription( Tests_ControllerTestSuite, suiteDescription_ControllerTestSuite, 1714, "testMultitonKeyIsSet" ) {}
  void runTest() { suite_ControllerTestSuite.testMultitonKeyIsSet(); }
 } testDescription_ControllerTestSuite_testMultitonKeyIsSet;
 
 static class TestDescription_ControllerTestSuite_testCanRegisterCommand : public CxxTest::RealTestDescription {
 public:
- TestDescription_ControllerTestSuite_testCanRegisterCommand() : CxxTest::RealTestDescription( Tests_ControllerTestSuite, suiteDescription_ControllerTestSuite, 590, "testCanRegisterCommand" ) {}
+ TestDescription_ControllerTestSuite_testCanRegisterCommand() : CxxTest::RealTestDescription( Tests_ControllerTestSuite, suiteDescription_ControllerTestSuite, 1718, "testCanRegisterCommand" ) {}
  void runTest() { suite_ControllerTestSuite.testCanRegisterCommand(); }
 } testDescription_ControllerTestSuite_testCanRegisterCommand;
 
 static class TestDescription_ControllerTestSuite_testCanExecuteCommandAndExecuteThroughNotification : public CxxTest::RealTestDescription {
 public:
- TestDescription_ControllerTestSuite_testCanExecuteCommandAndExecuteThroughNotification() : CxxTest::RealTestDescription( Tests_ControllerTestSuite, suiteDescription_ControllerTestSuite, 594, "testCanExecuteCommandAndExecuteThroughNotification" ) {}
+ TestDescription_ControllerTestSuite_testCanExecuteCommandAndExecuteThroughNotification() : CxxTest::RealTestDescription( Tests_ControllerTestSuite, suiteDescription_ControllerTestSuite, 1722, "testCanExecuteCommandAndExecuteThroughNotification" ) {}
  void runTest() { suite_ControllerTestSuite.testCanExecuteCommandAndExecuteThroughNotification(); }
 } testDescription_ControllerTestSuite_testCanExecuteCommandAndExecuteThroughNotification;
 
 static class TestDescription_ControllerTestSuite_testCanRemoveCommand : public CxxTest::RealTestDescription {
 public:
- TestDescription_ControllerTestSuite_testCanRemoveCommand() : CxxTest::RealTestDescription( Tests_ControllerTestSuite, suiteDescription_ControllerTestSuite, 601, "testCanRemoveCommand" ) {}
+ TestDescription_ControllerTestSuite_testCanRemoveCommand() : CxxTest::RealTestDescription( Tests_ControllerTestSuite, suiteDescription_ControllerTestSuite, 1729, "testCanRemoveCommand" ) {}
  void runTest() { suite_ControllerTestSuite.testCanRemoveCommand(); }
 } testDescription_ControllerTestSuite_testCanRemoveCommand;
 
+static class TestDescription_ControllerTestSuite_testCommandLifetimes : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ControllerTestSuite_testCommandLifetimes() : CxxTest::RealTestDescription( Tests_ControllerTestSuite, suiteDescription_ControllerTestSuite, 1737, "testCommandLifetimes" ) {}
+ void runTest() { suite_ControllerTestSuite.testCommandLifetimes(); }
+} testDescription_ControllerTestSuite_testCommandLifetimes;
+
+static class TestDescription_ControllerTestSuite_testThrowingCommandsAreHandedBack : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ControllerTestSuite_testThrowingCommandsAreHandedBack() : CxxTest::RealTestDescription( Tests_ControllerTestSuite, suiteDescription_ControllerTestSuite, 1753, "testThrowingCommandsAreHandedBack" ) {}
+ void runTest() { suite_ControllerTestSuite.testThrowingCommandsAreHandedBack(); }
+} testDescription_ControllerTestSuite_testThrowingCommandsAreHandedBack;
+
+static class TestDescription_ControllerTestSuite_testCommandsFollowTheViewsDenseNameLimit : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ControllerTestSuite_testCommandsFollowTheViewsDenseNameLimit() : CxxTest::RealTestDescription( Tests_ControllerTestSuite, suiteDescription_ControllerTestSuite, 1769, "testCommandsFollowTheViewsDenseNameLimit" ) {}
+ void runTest() { suite_ControllerTestSuite.testCommandsFollowTheViewsDenseNameLimit(); }
+} testDescription_ControllerTestSuite_testCommandsFollowTheViewsDenseNameLimit;
+
+static class TestDescription_ControllerTestSuite_testParallelCommandsRunOnThePool : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ControllerTestSuite_testParallelCommandsRunOnThePool() : CxxTest::RealTestDescription( Tests_ControllerTestSuite, suiteDescription_ControllerTestSuite, 1792, "testParallelCommandsRunOnThePool" ) {}
+ void runTest() { suite_ControllerTestSuite.testParallelCommandsRunOnThePool(); }
+} testDescription_ControllerTestSuite_testParallelCommandsRunOnThePool;
+
 static class TestDescription_ControllerTestSuite_testCanRemoveController : public CxxTest::RealTestDescription {
 public:
- TestDescription_ControllerTestSuite_testCanRemoveController() : CxxTest::RealTestDescription( Tests_ControllerTestSuite, suiteDescription_ControllerTestSuite, 609, "testCanRemoveController" ) {}
+ TestDescription_ControllerTestSuite_testCanRemoveController() : CxxTest::RealTestDescription( Tests_ControllerTestSuite, suiteDescription_ControllerTestSuite, 1815, "testCanRemoveController" ) {}
  void runTest() { suite_ControllerTestSuite.testCanRemoveController(); }
 } testDescription_ControllerTestSuite_testCanRemoveController;
 
+static ThreadPoolTestSuite suite_ThreadPoolTestSuite;
+
+static CxxTest::List Tests_ThreadPoolTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_ThreadPoolTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 1868, "ThreadPoolTestSuite", suite_ThreadPoolTestSuite, Tests_ThreadPoolTestSuite );
+
+static class TestDescription_ThreadPoolTestSuite_testRunsEveryTaskSubmittedFromTasks : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ThreadPoolTestSuite_testRunsEveryTaskSubmittedFromTasks() : CxxTest::RealTestDescription( Tests_ThreadPoolTestSuite, suiteDescription_ThreadPoolTestSuite, 1871, "testRunsEveryTaskSubmittedFromTasks" ) {}
+ void runTest() { suite_ThreadPoolTestSuite.testRunsEveryTaskSubmittedFromTasks(); }
+} testDescription_ThreadPoolTestSuite_testRunsEveryTaskSubmittedFromTasks;
+
+static class TestDescription_ThreadPoolTestSuite_testSharedPoolHasAWorkerPerProcessor : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ThreadPoolTestSuite_testSharedPoolHasAWorkerPerProcessor() : CxxTest::RealTestDescription( Tests_ThreadPoolTestSuite, suiteDescription_ThreadPoolTestSuite, 1885, "testSharedPoolHasAWorkerPerProcessor" ) {}
+ void runTest() { suite_ThreadPoolTestSuite.testSharedPoolHasAWorkerPerProcessor(); }
+} testDescription_ThreadPoolTestSuite_testSharedPoolHasAWorkerPerProcessor;
+
+static NotificationPoolTestSuite suite_NotificationPoolTestSuite;
+
+static CxxTest::List Tests_NotificationPoolTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_NotificationPoolTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 1899, "NotificationPoolTestSuite", suite_NotificationPoolTestSuite, Tests_NotificationPoolTestSuite );
+
+static class TestDescription_NotificationPoolTestSuite_testRecyclesNotificationsAcrossThreads : public CxxTest::RealTestDescription {
+public:
+ TestDescription_NotificationPoolTestSuite_testRecyclesNotificationsAcrossThreads() : CxxTest::RealTestDescription( Tests_NotificationPoolTestSuite, suiteDescription_NotificationPoolTestSuite, 1902, "testRecyclesNotificationsAcrossThreads" ) {}
+ void runTest() { suite_NotificationPoolTestSuite.testRecyclesNotificationsAcrossThreads(); }
+} testDescription_NotificationPoolTestSuite_testRecyclesNotificationsAcrossThreads;
+
+static NotificationRingTestSuite suite_NotificationRingTestSuite;
+
+static CxxTest::List Tests_NotificationRingTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_NotificationRingTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 1947, "NotificationRingTestSuite", suite_NotificationRingTestSuite, Tests_NotificationRingTestSuite );
+
+static class TestDescription_NotificationRingTestSuite_testFullRingsFollowTheirPolicy : public CxxTest::RealTestDescription {
+public:
+ TestDescription_NotificationRingTestSuite_testFullRingsFollowTheirPolicy() : CxxTest::RealTestDescription( Tests_NotificationRingTestSuite, suiteDescription_NotificationRingTestSuite, 1950, "testFullRingsFollowTheirPolicy" ) {}
+ void runTest() { suite_NotificationRingTestSuite.testFullRingsFollowTheirPolicy(); }
+} testDescription_NotificationRingTestSuite_testFullRingsFollowTheirPolicy;
+
+static class TestDescription_NotificationRingTestSuite_testProducersBlockUntilTheConsumerCatchesUp : public CxxTest::RealTestDescription {
+public:
+ TestDescription_NotificationRingTestSuite_testProducersBlockUntilTheConsumerCatchesUp() : CxxTest::RealTestDescription( Tests_NotificationRingTestSuite, suiteDescription_NotificationRingTestSuite, 1976, "testProducersBlockUntilTheConsumerCatchesUp" ) {}
+ void runTest() { suite_NotificationRingTestSuite.testProducersBlockUntilTheConsumerCatchesUp(); }
+} testDescription_NotificationRingTestSuite_testProducersBlockUntilTheConsumerCatchesUp;
+
+static class TestDescription_NotificationRingTestSuite_testBlockedProducersSleepUntilAPopMakesRoom : public CxxTest::RealTestDescription {
+public:
+ TestDescription_NotificationRingTestSuite_testBlockedProducersSleepUntilAPopMakesRoom() : CxxTest::RealTestDescription( Tests_NotificationRingTestSuite, suiteDescription_NotificationRingTestSuite, 2010, "testBlockedProducersSleepUntilAPopMakesRoom" ) {}
+ void runTest() { suite_NotificationRingTestSuite.testBlockedProducersSleepUntilAPopMakesRoom(); }
+} testDescription_NotificationRingTestSuite_testBlockedProducersSleepUntilAPopMakesRoom;
+
+static TimerWheelTestSuite suite_TimerWheelTestSuite;
+
+static CxxTest::List Tests_TimerWheelTestSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_TimerWheelTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 2044, "TimerWheelTestSuite", suite_TimerWheelTestSuite, Tests_TimerWheelTestSuite );
+
+static class TestDescription_TimerWheelTestSuite_testTimersPostOnTheirTickAtEveryLevel : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TimerWheelTestSuite_testTimersPostOnTheirTickAtEveryLevel() : CxxTest::RealTestDescription( Tests_TimerWheelTestSuite, suiteDescription_TimerWheelTestSuite, 2047, "testTimersPostOnTheirTickAtEveryLevel" ) {}
+ void runTest() { suite_TimerWheelTestSuite.testTimersPostOnTheirTickAtEveryLevel(); }
+} testDescription_TimerWheelTestSuite_testTimersPostOnTheirTickAtEveryLevel;
+
+static class TestDescription_TimerWheelTestSuite_testPeriodicTimersRepeatUntilCancelled : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TimerWheelTestSuite_testPeriodicTimersRepeatUntilCancelled() : CxxTest::RealTestDescription( Tests_TimerWheelTestSuite, suiteDescription_TimerWheelTestSuite, 2094, "testPeriodicTimersRepeatUntilCancelled" ) {}
+ void runTest() { suite_TimerWheelTestSuite.testPeriodicTimersRepeatUntilCancelled(); }
+} testDescription_TimerWheelTestSuite_testPeriodicTimersRepeatUntilCancelled;
+
 static FacadeTestSuite suite_FacadeTestSuite;
 
 static CxxTest::List Tests_FacadeTestSuite = { 0, 0 };
-CxxTest::StaticSuiteDescription suiteDescription_FacadeTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 643, "FacadeTestSuite", suite_FacadeTestSuite, Tests_FacadeTestSuite );
+CxxTest::StaticSuiteDescription suiteDescription_FacadeTestSuite( "/Users/schell/Code/PureMVC-Plus-Plus/test/pmvcarchTestSuite.h", 2173, "FacadeTestSuite", suite_FacadeTestSuite, Tests_FacadeTestSuite );
 
 static class TestDescription_FacadeTestSuite_testMultitonKeysAreSet : public CxxTest::RealTestDescription {
 public:
- TestDescription_FacadeTestSuite_testMultitonKeysAreSet() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 659, "testMultitonKeysAreSet" ) {}
+ TestDescription_FacadeTestSuite_testMultitonKeysAreSet() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2189, "testMultitonKeysAreSet" ) {}
  void runTest() { suite_FacadeTestSuite.testMultitonKeysAreSet(); }
 } testDescription_FacadeTestSuite_testMultitonKeysAreSet;
 
 static class TestDescription_FacadeTestSuite_testCanRegisterAndRemoveCommand : public CxxTest::RealTestDescription {
 public:
- TestDescription_FacadeTestSuite_testCanRegisterAndRemoveCommand() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 666, "testCanRegisterAndRemoveCommand" ) {}
+ TestDescription_FacadeTestSuite_testCanRegisterAndRemoveCommand() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2196, "testCanRegisterAndRemoveCommand" ) {}
  void runTest() { suite_FacadeTestSuite.testCanRegisterAndRemoveCommand(); }
 } testDescription_FacadeTestSuite_testCanRegisterAndRemoveCommand;
 
 static class TestDescription_FacadeTestSuite_testCanRegisterAndRetrieveAndRemoveProxy : public CxxTest::RealTestDescription {
 public:
- TestDescription_FacadeTestSuite_testCanRegisterAndRetrieveAndRemoveProxy() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 674, "testCanRegisterAndRetrieveAndRemoveProxy" ) {}
+ TestDescription_FacadeTestSuite_testCanRegisterAndRetrieveAndRemoveProxy() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2204, "testCanRegisterAndRetrieveAndRemoveProxy" ) {}
  void runTest() { suite_FacadeTestSuite.testCanRegisterAndRetrieveAndRemoveProxy(); }
 } testDescription_FacadeTestSuite_testCanRegisterAndRetrieveAndRemoveProxy;
 
 static class TestDescription_FacadeTestSuite_testCanRegisterAndRetrieveAndRemoveMediator : public CxxTest::RealTestDescription {
 public:
- TestDescription_FacadeTestSuite_testCanRegisterAndRetrieveAndRemoveMediator() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 684, "testCanRegisterAndRetrieveAndRemoveMediator" ) {}
+ TestDescription_FacadeTestSuite_testCanRegisterAndRetrieveAndRemoveMediator() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2214, "testCanRegisterAndRetrieveAndRemoveMediator" ) {}
  void runTest() { suite_FacadeTestSuite.testCanRegisterAndRetrieveAndRemoveMediator(); }
 } testDescription_FacadeTestSuite_testCanRegisterAndRetrieveAndRemoveMediator;
 
 static class TestDescription_FacadeTestSuite_testCanSendNotificationToCommand : public CxxTest::RealTestDescription {
 public:
- TestDescription_FacadeTestSuite_testCanSendNotificationToCommand() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 694, "testCanSendNotificationToCommand" ) {}
+ TestDescription_FacadeTestSuite_testCanSendNotificationToCommand() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2224, "testCanSendNotificationToCommand" ) {}
  void runTest() { suite_FacadeTestSuite.testCanSendNotificationToCommand(); }
 } testDescription_FacadeTestSuite_testCanSendNotificationToCommand;
 
 static class TestDescription_FacadeTestSuite_testCanSendNotificationToMediator : public CxxTest::RealTestDescription {
 public:
- TestDescription_FacadeTestSuite_testCanSendNotificationToMediator() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 700, "testCanSendNotificationToMediator" ) {}
+ TestDescription_FacadeTestSuite_testCanSendNotificationToMediator() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2230, "testCanSendNotificationToMediator" ) {}
  void runTest() { suite_FacadeTestSuite.testCanSendNotificationToMediator(); }
 } testDescription_FacadeTestSuite_testCanSendNotificationToMediator;
 
+static class TestDescription_FacadeTestSuite_testSendNotificationsDeliversBatches : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FacadeTestSuite_testSendNotificationsDeliversBatches() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2237, "testSendNotificationsDeliversBatches" ) {}
+ void runTest() { suite_FacadeTestSuite.testSendNotificationsDeliversBatches(); }
+} testDescription_FacadeTestSuite_testSendNotificationsDeliversBatches;
+
+static class TestDescription_FacadeTestSuite_testSendNotificationDoesNotAllocate : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FacadeTestSuite_testSendNotificationDoesNotAllocate() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2268, "testSendNotificationDoesNotAllocate" ) {}
+ void runTest() { suite_FacadeTestSuite.testSendNotificationDoesNotAllocate(); }
+} testDescription_FacadeTestSuite_testSendNotificationDoesNotAllocate;
+
+static class TestDescription_FacadeTestSuite_testTypedNotificationsReachPayloadHandlers : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FacadeTestSuite_testTypedNotificationsReachPayloadHandlers() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2284, "testTypedNotificationsReachPayloadHandlers" ) {}
+ void runTest() { suite_FacadeTestSuite.testTypedNotificationsReachPayloadHandlers(); }
+} testDescription_FacadeTestSuite_testTypedNotificationsReachPayloadHandlers;
+
+static class TestDescription_FacadeTestSuite_testPostedNotificationsRunToCompletion : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FacadeTestSuite_testPostedNotificationsRunToCompletion() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2321, "testPostedNotificationsRunToCompletion" ) {}
+ void runTest() { suite_FacadeTestSuite.testPostedNotificationsRunToCompletion(); }
+} testDescription_FacadeTestSuite_testPostedNotificationsRunToCompletion;
+
+static class TestDescription_FacadeTestSuite_testCoalescedPostsDeliverTheLatestBody : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FacadeTestSuite_testCoalescedPostsDeliverTheLatestBody() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2337, "testCoalescedPostsDeliverTheLatestBody" ) {}
+ void runTest() { suite_FacadeTestSuite.testCoalescedPostsDeliverTheLatestBody(); }
+} testDescription_FacadeTestSuite_testCoalescedPostsDeliverTheLatestBody;
+
+static class TestDescription_FacadeTestSuite_testTimersPostFromTheEventLoop : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FacadeTestSuite_testTimersPostFromTheEventLoop() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2373, "testTimersPostFromTheEventLoop" ) {}
+ void runTest() { suite_FacadeTestSuite.testTimersPostFromTheEventLoop(); }
+} testDescription_FacadeTestSuite_testTimersPostFromTheEventLoop;
+
+static class TestDescription_FacadeTestSuite_testPostedPayloadsOutliveTheSender : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FacadeTestSuite_testPostedPayloadsOutliveTheSender() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2405, "testPostedPayloadsOutliveTheSender" ) {}
+ void runTest() { suite_FacadeTestSuite.testPostedPayloadsOutliveTheSender(); }
+} testDescription_FacadeTestSuite_testPostedPayloadsOutliveTheSender;
+
+static class TestDescription_FacadeTestSuite_testEventLoopDeliversPostsFromAnotherThread : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FacadeTestSuite_testEventLoopDeliversPostsFromAnotherThread() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2424, "testEventLoopDeliversPostsFromAnotherThread" ) {}
+ void runTest() { suite_FacadeTestSuite.testEventLoopDeliversPostsFromAnotherThread(); }
+} testDescription_FacadeTestSuite_testEventLoopDeliversPostsFromAnotherThread;
+
+static class TestDescription_FacadeTestSuite_testInboxWakesTheEventLoop : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FacadeTestSuite_testInboxWakesTheEventLoop() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2442, "testInboxWakesTheEventLoop" ) {}
+ void runTest() { suite_FacadeTestSuite.testInboxWakesTheEventLoop(); }
+} testDescription_FacadeTestSuite_testInboxWakesTheEventLoop;
+
+static class TestDescription_FacadeTestSuite_testFullBlockingInboxRefusesItsOwnCore : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FacadeTestSuite_testFullBlockingInboxRefusesItsOwnCore() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2467, "testFullBlockingInboxRefusesItsOwnCore" ) {}
+ void runTest() { suite_FacadeTestSuite.testFullBlockingInboxRefusesItsOwnCore(); }
+} testDescription_FacadeTestSuite_testFullBlockingInboxRefusesItsOwnCore;
+
+static class TestDescription_FacadeTestSuite_testRunToCompletionDefersNestedSends : public CxxTest::RealTestDescription {
+public:
+ TestDescription_FacadeTestSuite_testRunToCompletionDefersNestedSends() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2485, "testRunToCompletionDefersNestedSends" ) {}
+ void runTest() { suite_FacadeTestSuite.testRunToCompletionDefersNestedSends(); }
+} testDescription_FacadeTestSuite_testRunToCompletionDefersNestedSends;
+
 static class TestDescription_FacadeTestSuite_testCanRemoveCore : public CxxTest::RealTestDescription {
 public:
- TestDescription_FacadeTestSuite_testCanRemoveCore() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 707, "testCanRemoveCore" ) {}
+ TestDescription_FacadeTestSuite_testCanRemoveCore() : CxxTest::RealTestDescription( Tests_FacadeTestSuite, suiteDescription_FacadeTestSuite, 2533, "testCanRemoveCore" ) {}
  void runTest() { suite_FacadeTestSuite.testCanRemoveCore(); }
 } testDescription_FacadeTestSuite_testCanRemoveCore;
 